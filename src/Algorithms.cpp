@@ -1,231 +1,1262 @@
-#include <QMatrix2x2>
-#include <QVector3D>
 #include <QPainter>
-#include <QtConcurrent/QtConcurrent>
 #include <QtMath>
 #include <QRect>
-#include <numeric>
 #include <vector>
 
 #include "Algorithms.h"
+#include "Executor.h"
+#include "Simd.h"
 
-void Naive(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset)
+namespace
 {
-    QImage temp = Sour2Dest(dest.size(), *sour, offset);
-    const float sin = qSin(theta);
-    const float cos = qCos(theta);
+/*!
+ * \brief The parameters of the inverse mapping shared by all rows of a rotation
+ */
+struct RotationParams
+{
+    const QRgb* sour;
+    qsizetype sourStride;
+    QRgb* dest;
+    qsizetype destStride;
+    int width;
+    int height;
+    int left;
+    int top;
+    int centerX;
+    int centerY;
+    float cos;
+    float sin;
+};
 
-    std::vector<int> xs(dest.width());
-    std::iota(begin(xs), end(xs), 0);
+using RotationRowKernel = void (*)(const RotationParams& p, const int& y, int x, const int& end);
 
-    QtConcurrent::blockingMap(xs, [&dest, &sour, &temp, &cos, &sin](const int& x) {
-        for (int y = 0; y < temp.height(); y++)
+// The vector kernels below evaluate exactly the same float expressions as the scalar one
+// (multiply, then add, then truncate), so all of them produce identical pixels.
+
+void naiveRowScalar(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    for (; x < end; x++)
+    {
+        int X = x - p.centerX;
+        int Y = y - p.centerY;
+        float sx = p.cos * X + p.sin * Y;
+        float sy = p.cos * Y - p.sin * X;
+        X = int(sx + p.centerX) - p.left;
+        Y = int(sy + p.centerY) - p.top;
+        if (X >= 0 && X < p.width && Y >= 0 && Y < p.height)
         {
-            int X = x - sour->width();
-            int Y = y - sour->height();
-            float sx = cos * X + sin * Y;
-            float sy = cos * Y - sin * X;
-            X = sx + sour->width();
-            Y = sy + sour->height();
-            if (X >= 0 && X < dest.width() && Y >= 0 && Y < dest.height())
-            {
-                dest.setPixelColor(x, y, temp.pixelColor(X, Y));
-            }
-            else
-            {
-                dest.setPixelColor(x, y, QColor(0, 0, 0, 0));
-            }
+            dest[x] = p.sour[Y * p.sourStride + X];
         }
-    });
+        else
+        {
+            dest[x] = 0;
+        }
+    }
 }
 
-void Shear(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset)
+#if defined(BEZIER_SIMD_X86)
+BEZIER_TARGET_SSE2 void naiveRowSSE2(const RotationParams& p, const int& y, int x, const int& end)
 {
-    QImage temp = Sour2Dest(dest.size(), *sour, offset);
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const __m128 cos = _mm_set1_ps(p.cos);
+    const __m128 sin = _mm_set1_ps(p.sin);
+    const __m128 sinY = _mm_set1_ps(p.sin * Y);
+    const __m128 cosY = _mm_set1_ps(p.cos * Y);
+    const __m128 centerX = _mm_set1_ps(p.centerX);
+    const __m128 centerY = _mm_set1_ps(p.centerY);
+    const __m128i left = _mm_set1_epi32(p.left);
+    const __m128i top = _mm_set1_epi32(p.top);
+    const __m128i minusOne = _mm_set1_epi32(-1);
+    const __m128i width = _mm_set1_epi32(p.width);
+    const __m128i height = _mm_set1_epi32(p.height);
+    const __m128i four = _mm_set1_epi32(4);
+    __m128i X = _mm_setr_epi32(x - p.centerX, x + 1 - p.centerX, x + 2 - p.centerX, x + 3 - p.centerX);
+
+    alignas(16) int xs[4];
+    alignas(16) int ys[4];
+    alignas(16) int valid[4];
+    for (; x + 4 <= end; x += 4)
+    {
+        const __m128 fX = _mm_cvtepi32_ps(X);
+        const __m128 sx = _mm_add_ps(_mm_mul_ps(cos, fX), sinY);
+        const __m128 sy = _mm_sub_ps(cosY, _mm_mul_ps(sin, fX));
+        const __m128i sX = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(sx, centerX)), left);
+        const __m128i sY = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(sy, centerY)), top);
+        const __m128i inX = _mm_and_si128(_mm_cmpgt_epi32(sX, minusOne), _mm_cmplt_epi32(sX, width));
+        const __m128i inY = _mm_and_si128(_mm_cmpgt_epi32(sY, minusOne), _mm_cmplt_epi32(sY, height));
+        _mm_store_si128(reinterpret_cast<__m128i*>(xs), sX);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ys), sY);
+        _mm_store_si128(reinterpret_cast<__m128i*>(valid), _mm_and_si128(inX, inY));
+        // SSE2 has no gather, the loads stay scalar
+        for (int i = 0; i < 4; i++)
+        {
+            dest[x + i] = valid[i] ? p.sour[ys[i] * p.sourStride + xs[i]] : 0;
+        }
+        X = _mm_add_epi32(X, four);
+    }
+    naiveRowScalar(p, y, x, end);
+}
 
-    std::vector<int> is(dest.width());
-    std::iota(begin(is), end(is), 0);
+BEZIER_TARGET_AVX2 void naiveRowAVX2(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const __m256 cos = _mm256_set1_ps(p.cos);
+    const __m256 sin = _mm256_set1_ps(p.sin);
+    const __m256 sinY = _mm256_set1_ps(p.sin * Y);
+    const __m256 cosY = _mm256_set1_ps(p.cos * Y);
+    const __m256 centerX = _mm256_set1_ps(p.centerX);
+    const __m256 centerY = _mm256_set1_ps(p.centerY);
+    const __m256i left = _mm256_set1_epi32(p.left);
+    const __m256i top = _mm256_set1_epi32(p.top);
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i width = _mm256_set1_epi32(p.width);
+    const __m256i height = _mm256_set1_epi32(p.height);
+    const __m256i stride = _mm256_set1_epi32(p.sourStride);
+    const __m256i eight = _mm256_set1_epi32(8);
+    const int* sour = reinterpret_cast<const int*>(p.sour);
+    __m256i X = _mm256_add_epi32(_mm256_set1_epi32(x - p.centerX), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
 
-    float phi = theta;
-    if (theta >= 3 * M_PI / 2) {
-        phi = theta - 3 * M_PI / 2;
-        TurnImage_270(dest, temp, is);
+    for (; x + 8 <= end; x += 8)
+    {
+        const __m256 fX = _mm256_cvtepi32_ps(X);
+        const __m256 sx = _mm256_add_ps(_mm256_mul_ps(cos, fX), sinY);
+        const __m256 sy = _mm256_sub_ps(cosY, _mm256_mul_ps(sin, fX));
+        const __m256i sX = _mm256_sub_epi32(_mm256_cvttps_epi32(_mm256_add_ps(sx, centerX)), left);
+        const __m256i sY = _mm256_sub_epi32(_mm256_cvttps_epi32(_mm256_add_ps(sy, centerY)), top);
+        const __m256i inX = _mm256_and_si256(_mm256_cmpgt_epi32(sX, minusOne), _mm256_cmpgt_epi32(width, sX));
+        const __m256i inY = _mm256_and_si256(_mm256_cmpgt_epi32(sY, minusOne), _mm256_cmpgt_epi32(height, sY));
+        const __m256i valid = _mm256_and_si256(inX, inY);
+        const __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(sY, stride), sX);
+        // masked-off lanes are never loaded and stay transparent
+        const __m256i pixels = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), sour, index, valid, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x), pixels);
+        X = _mm256_add_epi32(X, eight);
     }
-    else if (theta >= M_PI)
+    naiveRowScalar(p, y, x, end);
+}
+#endif
+
+RotationRowKernel naiveRowKernel()
+{
+#if defined(BEZIER_SIMD_X86)
+    switch (simdLevel())
     {
-        phi = theta - M_PI;
-        TurnImage_180(dest, temp, is);
+        case SimdLevel::AVX2:
+        {
+            return naiveRowAVX2;
+        }
+        case SimdLevel::SSE2:
+        {
+            return naiveRowSSE2;
+        }
+        default:
+        {
+            break;
+        }
     }
-    else if (theta >= M_PI / 2)
+#endif
+    return naiveRowScalar;
+}
+
+/*!
+ * \brief Narrows the columns of a row to those whose inverse mapping can land in a band of the source.
+ * \param slope The change of the source coordinate from one column to the next.
+ * \param base The source coordinate of the center column.
+ * \param lo The lower edge of the band.
+ * \param hi The upper edge of the band.
+ * \param from The first column relative to the center, raised to the band.
+ * \param to The last column relative to the center, lowered to the band.
+ */
+void clipToBand(const double& slope, const double& base, const double& lo, const double& hi, double& from, double& to)
+{
+    if (slope == 0.0)
     {
-        phi = theta - M_PI / 2;
-        TurnImage_90(dest, temp, is);
+        if (base < lo || base > hi)
+        {
+            to = from - 1;
+        }
+        return;
     }
+    const double a = (lo - base) / slope;
+    const double b = (hi - base) / slope;
+    from = qMax(from, qMin(a, b));
+    to = qMin(to, qMax(a, b));
+}
 
-    const float sin = qSin(phi);
-    const float tan = -qTan(phi / 2);
+/*!
+ * \brief The buffers shared by all rows of a shear pass
+ */
+struct ShearParams
+{
+    const QRgb* sour;
+    qsizetype sourStride;
+    QRgb* dest;
+    qsizetype destStride;
+    int width;
+    int height;
+};
 
-    ShearX(dest, temp, tan, is);
-    ShearY(temp, dest, sin, is);
-    ShearX(dest, temp, tan, is);
+using ShearRowKernel = void (*)(const ShearParams& p, const int& y, const int& shift, const int& weight);
+using ShearColumnsKernel = void (*)(const ShearParams& p, const int& y, const int* shifts, const int* weights);
+
+/*!
+ * \brief Converts the fractional part of a shift into an 8-bit fixed-point weight.
+ * \param f The fraction in [0, 1).
+ * \return The weight of the next pixel in [0, 256].
+ */
+inline int shearWeight(const float& f)
+{
+    return qRound(f * 256);
 }
 
-void ShearX(QImage& dest, QImage& sour, const float& lambda, const std::vector<int>& ys)
+/*!
+ * \brief Blends two pixels channel-wise with a fixed-point weight, two channels per multiply.
+ * \param a The first pixel.
+ * \param b The second pixel.
+ * \param w The weight of the second pixel in [0, 256].
+ * \return (a * (256 - w) + b * w + 128) / 256 for every channel.
+ */
+inline QRgb lerpPixel(const QRgb& a, const QRgb& b, const uint& w)
 {
-    const QSize& size = dest.size();
-    dest.fill(QColor(0, 0, 0, 0));
+    const uint iw = 256 - w;
+    const uint rb = (((a & 0x00ff00ff) * iw + (b & 0x00ff00ff) * w + 0x00800080) >> 8) & 0x00ff00ff;
+    const uint ag = (((a >> 8) & 0x00ff00ff) * iw + ((b >> 8) & 0x00ff00ff) * w + 0x00800080) & 0xff00ff00;
+    return rb | ag;
+}
 
-    QtConcurrent::blockingMap(ys, [&dest, &sour, &lambda, &size](const int& y) {
-        const float ly = lambda * (y - sour.height() / 2);
-        const int dx = qFloor(ly);
-        const float f = ly - dx;
+// The shear passes are written as inverse mappings: every destination pixel is computed exactly once
+// from the source pixel it came from and its right (or lower) neighbour, with the last pixel of a row
+// (or column) blended with itself, which is the plain copy the forward formulation made.
+
+void shearRowScalar(const ShearParams& p, const int& y, const int& shift, const int& weight)
+{
+    const QRgb* sour = p.sour + y * p.sourStride;
+    QRgb* dest = p.dest + y * p.destStride;
+    const int from = qBound(0, shift, p.width);
+    const int to = qBound(0, shift + p.width, p.width);
+    std::fill(dest, dest + from, 0);
+    for (int x = from; x < to; x++)
+    {
+        const int X = x - shift;
+        dest[x] = lerpPixel(sour[X], sour[qMin(X + 1, p.width - 1)], weight);
+    }
+    std::fill(dest + to, dest + p.width, 0);
+}
 
-        QColor righCol = sour.pixelColor(0, y);
-        for (int x = 0; x < size.width() - 1; x++)
+void shearColumnsScalar(const ShearParams& p, const int& y, const int* shifts, const int* weights)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    for (int x = 0; x < p.width; x++)
+    {
+        const int Y = y - shifts[x];
+        if (Y >= 0 && Y < p.height)
         {
-            const int newX = x + dx;
-            if (newX < 0 || newX >= size.width()) { continue; }
-            const QColor currCol = righCol;
-            righCol = sour.pixelColor(x + 1, y);
+            dest[x] = lerpPixel(p.sour[Y * p.sourStride + x], p.sour[qMin(Y + 1, p.height - 1) * p.sourStride + x], weights[x]);
+        }
+        else
+        {
+            dest[x] = 0;
+        }
+    }
+}
 
-            QColor sum;
-            if (currCol.alpha() == 0 && righCol.alpha() == 0)
-            {
-                sum = QColor(0, 0, 0, 0);
-            }
-            else if (currCol.alpha() == 0)
-            {
-                sum = righCol;
-            }
-            else if (righCol.alpha() == 0)
+#if defined(BEZIER_SIMD_X86)
+/*!
+ * \brief Blends four pixel pairs, the same way as lerpPixel.
+ * \param a The first pixels.
+ * \param b The second pixels.
+ * \param wlo The 16-bit weights for the channels of the two lower pixels.
+ * \param whi The 16-bit weights for the channels of the two upper pixels.
+ * \return The blended pixels.
+ */
+BEZIER_TARGET_SSE2 inline __m128i lerp4(const __m128i& a, const __m128i& b, const __m128i& wlo, const __m128i& whi)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(256);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_sub_epi16(full, wlo)),
+                                                   _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wlo)), half);
+    const __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_sub_epi16(full, whi)),
+                                                   _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), whi)), half);
+    return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+
+/*!
+ * \brief Blends eight pixel pairs, the same way as lerpPixel.
+ * \param a The first pixels.
+ * \param b The second pixels.
+ * \param wlo The 16-bit weights for the channels of the pixels unpacked from the low halves of the lanes.
+ * \param whi The 16-bit weights for the channels of the pixels unpacked from the high halves of the lanes.
+ * \return The blended pixels.
+ */
+BEZIER_TARGET_AVX2 inline __m256i lerp8(const __m256i& a, const __m256i& b, const __m256i& wlo, const __m256i& whi)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i full = _mm256_set1_epi16(256);
+    const __m256i half = _mm256_set1_epi16(128);
+    const __m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_sub_epi16(full, wlo)),
+                                                         _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), wlo)), half);
+    const __m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_sub_epi16(full, whi)),
+                                                         _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), whi)), half);
+    return _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+}
+
+BEZIER_TARGET_SSE2 void shearRowSSE2(const ShearParams& p, const int& y, const int& shift, const int& weight)
+{
+    const QRgb* sour = p.sour + y * p.sourStride;
+    QRgb* dest = p.dest + y * p.destStride;
+    const int from = qBound(0, shift, p.width);
+    const int to = qBound(0, shift + p.width, p.width);
+    const __m128i w = _mm_set1_epi16(weight);
+    std::fill(dest, dest + from, 0);
+    int x = from;
+    // the neighbours are read one pixel ahead, so the vector loop stops before the last source pixel
+    for (; x + 4 <= to && x - shift + 4 < p.width; x += 4)
+    {
+        const QRgb* s = sour + x - shift;
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), lerp4(a, b, w, w));
+    }
+    for (; x < to; x++)
+    {
+        const int X = x - shift;
+        dest[x] = lerpPixel(sour[X], sour[qMin(X + 1, p.width - 1)], weight);
+    }
+    std::fill(dest + to, dest + p.width, 0);
+}
+
+BEZIER_TARGET_SSE2 void shearColumnsSSE2(const ShearParams& p, const int& y, const int* shifts, const int* weights)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    int x = 0;
+    alignas(16) QRgb a[4];
+    alignas(16) QRgb b[4];
+    for (; x + 4 <= p.width; x += 4)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            const int Y = y - shifts[x + i];
+            const bool valid = Y >= 0 && Y < p.height;
+            a[i] = valid ? p.sour[Y * p.sourStride + x + i] : 0;
+            b[i] = valid ? p.sour[qMin(Y + 1, p.height - 1) * p.sourStride + x + i] : 0;
+        }
+        // every pixel has its own weight, duplicated into the 16-bit lanes of its four channels
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + x));
+        const __m128i w2 = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+        const __m128i pixels = lerp4(_mm_load_si128(reinterpret_cast<const __m128i*>(a)),
+                                     _mm_load_si128(reinterpret_cast<const __m128i*>(b)),
+                                     _mm_unpacklo_epi32(w2, w2), _mm_unpackhi_epi32(w2, w2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), pixels);
+    }
+    for (; x < p.width; x++)
+    {
+        const int Y = y - shifts[x];
+        if (Y >= 0 && Y < p.height)
+        {
+            dest[x] = lerpPixel(p.sour[Y * p.sourStride + x], p.sour[qMin(Y + 1, p.height - 1) * p.sourStride + x], weights[x]);
+        }
+        else
+        {
+            dest[x] = 0;
+        }
+    }
+}
+
+BEZIER_TARGET_AVX2 void shearRowAVX2(const ShearParams& p, const int& y, const int& shift, const int& weight)
+{
+    const QRgb* sour = p.sour + y * p.sourStride;
+    QRgb* dest = p.dest + y * p.destStride;
+    const int from = qBound(0, shift, p.width);
+    const int to = qBound(0, shift + p.width, p.width);
+    const __m256i w = _mm256_set1_epi16(weight);
+    std::fill(dest, dest + from, 0);
+    int x = from;
+    for (; x + 8 <= to && x - shift + 8 < p.width; x += 8)
+    {
+        const QRgb* s = sour + x - shift;
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x), lerp8(a, b, w, w));
+    }
+    for (; x < to; x++)
+    {
+        const int X = x - shift;
+        dest[x] = lerpPixel(sour[X], sour[qMin(X + 1, p.width - 1)], weight);
+    }
+    std::fill(dest + to, dest + p.width, 0);
+}
+
+BEZIER_TARGET_AVX2 void shearColumnsAVX2(const ShearParams& p, const int& y, const int* shifts, const int* weights)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int* sour = reinterpret_cast<const int*>(p.sour);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i height = _mm256_set1_epi32(p.height);
+    const __m256i last = _mm256_set1_epi32(p.height - 1);
+    const __m256i stride = _mm256_set1_epi32(p.sourStride);
+    const __m256i eight = _mm256_set1_epi32(8);
+    __m256i X = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    int x = 0;
+    for (; x + 8 <= p.width; x += 8)
+    {
+        const __m256i Y = _mm256_sub_epi32(_mm256_set1_epi32(y), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(shifts + x)));
+        const __m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(Y, minusOne), _mm256_cmpgt_epi32(height, Y));
+        const __m256i index0 = _mm256_add_epi32(_mm256_mullo_epi32(Y, stride), X);
+        const __m256i index1 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_min_epi32(_mm256_add_epi32(Y, one), last), stride), X);
+        const __m256i a = _mm256_mask_i32gather_epi32(zero, sour, index0, valid, 4);
+        const __m256i b = _mm256_mask_i32gather_epi32(zero, sour, index1, valid, 4);
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + x));
+        const __m256i w2 = _mm256_or_si256(w, _mm256_slli_epi32(w, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x), lerp8(a, b, _mm256_unpacklo_epi32(w2, w2), _mm256_unpackhi_epi32(w2, w2)));
+        X = _mm256_add_epi32(X, eight);
+    }
+    for (; x < p.width; x++)
+    {
+        const int Y = y - shifts[x];
+        if (Y >= 0 && Y < p.height)
+        {
+            dest[x] = lerpPixel(p.sour[Y * p.sourStride + x], p.sour[qMin(Y + 1, p.height - 1) * p.sourStride + x], weights[x]);
+        }
+        else
+        {
+            dest[x] = 0;
+        }
+    }
+}
+#endif
+
+/*!
+ * \brief Returns a pixel of the source of a rotation, transparent outside of it.
+ * \param p The parameters of the rotation.
+ * \param X The column in the source.
+ * \param Y The row in the source.
+ * \return The pixel.
+ */
+inline QRgb sourcePixel(const RotationParams& p, const int& X, const int& Y)
+{
+    return X >= 0 && X < p.width && Y >= 0 && Y < p.height ? p.sour[Y * p.sourStride + X] : 0;
+}
+
+/*!
+ * \brief Rounds a float down to an integer, without the call to floor the baseline instruction set needs.
+ * \param v The float.
+ * \return The largest integer not greater than the float.
+ */
+inline int floorToInt(const float& v)
+{
+    const int t = int(v);
+    return v < t ? t - 1 : t;
+}
+
+/*!
+ * \brief Evaluates the Catmull-Rom weights of the four taps around a sample.
+ * \param t The fraction of the way from the second tap to the third.
+ * \param w The four weights.
+ */
+inline void cubicWeights(const float& t, float* w)
+{
+    w[0] = ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+    w[1] = (1.5f * t - 2.5f) * t * t + 1.0f;
+    w[2] = ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+    w[3] = (0.5f * t - 0.5f) * t * t;
+}
+
+// The filtered rotations sample the premultiplied source at the unrounded inverse mapping, with the pixels
+// past its edges transparent, so the edges of the sprite come out antialiased. The bilinear kernels blend
+// with the 8-bit weights of the shear passes and match each other exactly, the bicubic kernels sum the taps
+// in the same order in floats and match as well.
+
+void bilinearRowScalar(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const float baseX = p.sin * Y + (p.centerX - p.left);
+    const float baseY = p.cos * Y + (p.centerY - p.top);
+    for (; x < end; x++)
+    {
+        const int X = x - p.centerX;
+        const float sx = p.cos * X + baseX;
+        const float sy = baseY - p.sin * X;
+        const int X0 = floorToInt(sx);
+        const int Y0 = floorToInt(sy);
+        const uint wx = int((sx - X0) * 256.0f + 0.5f);
+        const uint wy = int((sy - Y0) * 256.0f + 0.5f);
+        const QRgb top = lerpPixel(sourcePixel(p, X0, Y0), sourcePixel(p, X0 + 1, Y0), wx);
+        const QRgb bottom = lerpPixel(sourcePixel(p, X0, Y0 + 1), sourcePixel(p, X0 + 1, Y0 + 1), wx);
+        dest[x] = lerpPixel(top, bottom, wy);
+    }
+}
+
+void bicubicRowScalar(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const float baseX = p.sin * Y + (p.centerX - p.left);
+    const float baseY = p.cos * Y + (p.centerY - p.top);
+    for (; x < end; x++)
+    {
+        const int X = x - p.centerX;
+        const float sx = p.cos * X + baseX;
+        const float sy = baseY - p.sin * X;
+        const int X0 = floorToInt(sx);
+        const int Y0 = floorToInt(sy);
+        float wx[4];
+        float wy[4];
+        cubicWeights(sx - X0, wx);
+        cubicWeights(sy - Y0, wy);
+        // the channels in the order of their bytes, blue first and alpha last
+        float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int j = 0; j < 4; j++)
+        {
+            float row[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (int i = 0; i < 4; i++)
             {
-                sum = currCol;
+                const QRgb q = sourcePixel(p, X0 - 1 + i, Y0 - 1 + j);
+                for (int c = 0; c < 4; c++)
+                {
+                    row[c] = row[c] + wx[i] * float((q >> (8 * c)) & 0xff);
+                }
             }
-            else
+            for (int c = 0; c < 4; c++)
             {
-                QVector3D curr = (1.0f - f) * QVector3D(currCol.red(), currCol.green(), currCol.blue());
-                QVector3D righ = f * QVector3D(righCol.red(), righCol.green(), righCol.blue());
-                sum = QColor(curr.x() + righ.x(), curr.y() + righ.y(), curr.z() + righ.z());
+                sum[c] = sum[c] + wy[j] * row[c];
             }
-            dest.setPixelColor(newX, y, sum);
         }
-        const int newX = dx + size.width() - 1;
-        if (newX >= 0 && newX < size.width())
+        // the overshoot of the filter is clamped, the colour never past the alpha of a premultiplied pixel
+        const float alpha = qMin(qMax(sum[3], 0.0f), 255.0f);
+        QRgb pixel = QRgb(int(alpha + 0.5f)) << 24;
+        for (int c = 0; c < 3; c++)
         {
-            dest.setPixelColor(newX, y, sour.pixelColor(size.width() - 1, y));
+            pixel |= QRgb(int(qMin(qMax(sum[c], 0.0f), alpha) + 0.5f)) << (8 * c);
         }
-    });
+        dest[x] = pixel;
+    }
 }
 
-void ShearY(QImage& dest, QImage& sour, const float& lambda, const std::vector<int>& xs)
+#if defined(BEZIER_SIMD_X86)
+/*!
+ * \brief Rounds four floats down to integers.
+ * \param v The floats.
+ * \return The largest integers not greater than the floats.
+ */
+BEZIER_TARGET_SSE2 inline __m128i floor4(const __m128& v)
 {
-    const QSize& size = dest.size();
-    dest.fill(QColor(0, 0, 0, 0));
+    const __m128i t = _mm_cvttps_epi32(v);
+    // the truncation rounded the negative fractions up, the mask is -1 exactly there
+    return _mm_add_epi32(t, _mm_castps_si128(_mm_cmplt_ps(v, _mm_cvtepi32_ps(t))));
+}
 
-    QtConcurrent::blockingMap(xs, [&dest, &sour, &lambda, &size](const int& x) {
-        const float lx = lambda * (x - sour.width() / 2);
-        const int dy = qFloor(lx);
-        const float f = lx - dy;
+BEZIER_TARGET_SSE2 void bilinearRowSSE2(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const __m128 cos = _mm_set1_ps(p.cos);
+    const __m128 sin = _mm_set1_ps(p.sin);
+    const __m128 baseX = _mm_set1_ps(p.sin * Y + (p.centerX - p.left));
+    const __m128 baseY = _mm_set1_ps(p.cos * Y + (p.centerY - p.top));
+    const __m128 scale = _mm_set1_ps(256.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128i four = _mm_set1_epi32(4);
+    __m128i X = _mm_setr_epi32(x - p.centerX, x + 1 - p.centerX, x + 2 - p.centerX, x + 3 - p.centerX);
 
-        QColor downCol = sour.pixelColor(x, 0);
-        for (int y = 0; y < size.height() - 1; y++)
+    alignas(16) int xs[4];
+    alignas(16) int ys[4];
+    alignas(16) QRgb taps[4][4];
+    for (; x + 4 <= end; x += 4)
+    {
+        const __m128 fX = _mm_cvtepi32_ps(X);
+        const __m128 sx = _mm_add_ps(_mm_mul_ps(cos, fX), baseX);
+        const __m128 sy = _mm_sub_ps(baseY, _mm_mul_ps(sin, fX));
+        const __m128i X0 = floor4(sx);
+        const __m128i Y0 = floor4(sy);
+        const __m128i wx = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(sx, _mm_cvtepi32_ps(X0)), scale), half));
+        const __m128i wy = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(sy, _mm_cvtepi32_ps(Y0)), scale), half));
+        _mm_store_si128(reinterpret_cast<__m128i*>(xs), X0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ys), Y0);
+        // SSE2 has no gather, the taps are loaded one by one, straight from the rows inside the source
+        for (int i = 0; i < 4; i++)
         {
-            const int newY = y + dy;
-            if (newY < 0 || newY >= size.height()) { continue; }
-            const QColor currCol = downCol;
-            downCol = sour.pixelColor(x, y + 1);
-
-            QColor sum;
-            if (currCol.alpha() == 0 && downCol.alpha() == 0)
+            if (uint(xs[i]) < uint(p.width - 1) && uint(ys[i]) < uint(p.height - 1))
             {
-                sum = QColor(0, 0, 0, 0);
+                const QRgb* s = p.sour + ys[i] * p.sourStride + xs[i];
+                taps[0][i] = s[0];
+                taps[1][i] = s[1];
+                taps[2][i] = s[p.sourStride];
+                taps[3][i] = s[p.sourStride + 1];
             }
-            else if (currCol.alpha() == 0)
-            {
-                sum = downCol;
-            }
-            else if (downCol.alpha() == 0)
+            else
             {
-                sum = currCol;
+                taps[0][i] = sourcePixel(p, xs[i], ys[i]);
+                taps[1][i] = sourcePixel(p, xs[i] + 1, ys[i]);
+                taps[2][i] = sourcePixel(p, xs[i], ys[i] + 1);
+                taps[3][i] = sourcePixel(p, xs[i] + 1, ys[i] + 1);
             }
-            else
+        }
+        // every pixel has its own weights, duplicated into the 16-bit lanes of its four channels
+        const __m128i wx2 = _mm_or_si128(wx, _mm_slli_epi32(wx, 16));
+        const __m128i wy2 = _mm_or_si128(wy, _mm_slli_epi32(wy, 16));
+        const __m128i wxlo = _mm_unpacklo_epi32(wx2, wx2);
+        const __m128i wxhi = _mm_unpackhi_epi32(wx2, wx2);
+        const __m128i top = lerp4(_mm_load_si128(reinterpret_cast<const __m128i*>(taps[0])),
+                                  _mm_load_si128(reinterpret_cast<const __m128i*>(taps[1])), wxlo, wxhi);
+        const __m128i bottom = lerp4(_mm_load_si128(reinterpret_cast<const __m128i*>(taps[2])),
+                                     _mm_load_si128(reinterpret_cast<const __m128i*>(taps[3])), wxlo, wxhi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), lerp4(top, bottom, _mm_unpacklo_epi32(wy2, wy2), _mm_unpackhi_epi32(wy2, wy2)));
+        X = _mm_add_epi32(X, four);
+    }
+    bilinearRowScalar(p, y, x, end);
+}
+
+BEZIER_TARGET_AVX2 void bilinearRowAVX2(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const __m256 cos = _mm256_set1_ps(p.cos);
+    const __m256 sin = _mm256_set1_ps(p.sin);
+    const __m256 baseX = _mm256_set1_ps(p.sin * Y + (p.centerX - p.left));
+    const __m256 baseY = _mm256_set1_ps(p.cos * Y + (p.centerY - p.top));
+    const __m256 scale = _mm256_set1_ps(256.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i width = _mm256_set1_epi32(p.width);
+    const __m256i height = _mm256_set1_epi32(p.height);
+    const __m256i stride = _mm256_set1_epi32(p.sourStride);
+    const __m256i eight = _mm256_set1_epi32(8);
+    const int* sour = reinterpret_cast<const int*>(p.sour);
+    __m256i X = _mm256_add_epi32(_mm256_set1_epi32(x - p.centerX), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    for (; x + 8 <= end; x += 8)
+    {
+        const __m256 fX = _mm256_cvtepi32_ps(X);
+        const __m256 sx = _mm256_add_ps(_mm256_mul_ps(cos, fX), baseX);
+        const __m256 sy = _mm256_sub_ps(baseY, _mm256_mul_ps(sin, fX));
+        const __m256 floorX = _mm256_floor_ps(sx);
+        const __m256 floorY = _mm256_floor_ps(sy);
+        const __m256i X0 = _mm256_cvttps_epi32(floorX);
+        const __m256i Y0 = _mm256_cvttps_epi32(floorY);
+        const __m256i X1 = _mm256_add_epi32(X0, one);
+        const __m256i Y1 = _mm256_add_epi32(Y0, one);
+        const __m256i wx = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(sx, floorX), scale), half));
+        const __m256i wy = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(sy, floorY), scale), half));
+        const __m256i inX0 = _mm256_and_si256(_mm256_cmpgt_epi32(X0, minusOne), _mm256_cmpgt_epi32(width, X0));
+        const __m256i inX1 = _mm256_and_si256(_mm256_cmpgt_epi32(X1, minusOne), _mm256_cmpgt_epi32(width, X1));
+        const __m256i inY0 = _mm256_and_si256(_mm256_cmpgt_epi32(Y0, minusOne), _mm256_cmpgt_epi32(height, Y0));
+        const __m256i inY1 = _mm256_and_si256(_mm256_cmpgt_epi32(Y1, minusOne), _mm256_cmpgt_epi32(height, Y1));
+        const __m256i row0 = _mm256_mullo_epi32(Y0, stride);
+        const __m256i row1 = _mm256_add_epi32(row0, stride);
+        // masked-off taps are never loaded and stay transparent
+        const __m256i a = _mm256_mask_i32gather_epi32(zero, sour, _mm256_add_epi32(row0, X0), _mm256_and_si256(inY0, inX0), 4);
+        const __m256i b = _mm256_mask_i32gather_epi32(zero, sour, _mm256_add_epi32(row0, X1), _mm256_and_si256(inY0, inX1), 4);
+        const __m256i c = _mm256_mask_i32gather_epi32(zero, sour, _mm256_add_epi32(row1, X0), _mm256_and_si256(inY1, inX0), 4);
+        const __m256i d = _mm256_mask_i32gather_epi32(zero, sour, _mm256_add_epi32(row1, X1), _mm256_and_si256(inY1, inX1), 4);
+        const __m256i wx2 = _mm256_or_si256(wx, _mm256_slli_epi32(wx, 16));
+        const __m256i wy2 = _mm256_or_si256(wy, _mm256_slli_epi32(wy, 16));
+        const __m256i wxlo = _mm256_unpacklo_epi32(wx2, wx2);
+        const __m256i wxhi = _mm256_unpackhi_epi32(wx2, wx2);
+        const __m256i top = lerp8(a, b, wxlo, wxhi);
+        const __m256i bottom = lerp8(c, d, wxlo, wxhi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x), lerp8(top, bottom, _mm256_unpacklo_epi32(wy2, wy2), _mm256_unpackhi_epi32(wy2, wy2)));
+        X = _mm256_add_epi32(X, eight);
+    }
+    bilinearRowScalar(p, y, x, end);
+}
+
+BEZIER_TARGET_SSE2 void bicubicRowSSE2(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const float baseX = p.sin * Y + (p.centerX - p.left);
+    const float baseY = p.cos * Y + (p.centerY - p.top);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 full = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    // the channels of a pixel fill the four lanes, so every pixel is a single vector
+    for (; x < end; x++)
+    {
+        const int X = x - p.centerX;
+        const float sx = p.cos * X + baseX;
+        const float sy = baseY - p.sin * X;
+        const int X0 = floorToInt(sx);
+        const int Y0 = floorToInt(sy);
+        float wx[4];
+        float wy[4];
+        cubicWeights(sx - X0, wx);
+        cubicWeights(sy - Y0, wy);
+        const bool isInside = X0 >= 1 && X0 + 2 < p.width && Y0 >= 1 && Y0 + 2 < p.height;
+        const __m128 wx0 = _mm_set1_ps(wx[0]);
+        const __m128 wx1 = _mm_set1_ps(wx[1]);
+        const __m128 wx2 = _mm_set1_ps(wx[2]);
+        const __m128 wx3 = _mm_set1_ps(wx[3]);
+        __m128 sum = _mm_setzero_ps();
+        for (int j = 0; j < 4; j++)
+        {
+            // the four taps of a row in one load inside the source, one by one along its edges
+            const __m128i taps = isInside
+                ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(p.sour + (Y0 - 1 + j) * p.sourStride + X0 - 1))
+                : _mm_setr_epi32(int(sourcePixel(p, X0 - 1, Y0 - 1 + j)), int(sourcePixel(p, X0, Y0 - 1 + j)),
+                                 int(sourcePixel(p, X0 + 1, Y0 - 1 + j)), int(sourcePixel(p, X0 + 2, Y0 - 1 + j)));
+            const __m128i lo = _mm_unpacklo_epi8(taps, zero);
+            const __m128i hi = _mm_unpackhi_epi8(taps, zero);
+            __m128 row = _mm_mul_ps(wx0, _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+            row = _mm_add_ps(row, _mm_mul_ps(wx1, _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero))));
+            row = _mm_add_ps(row, _mm_mul_ps(wx2, _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero))));
+            row = _mm_add_ps(row, _mm_mul_ps(wx3, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero))));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(wy[j]), row));
+        }
+        const __m128 alpha = _mm_min_ps(_mm_max_ps(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 3, 3)), _mm_setzero_ps()), full);
+        const __m128i channels = _mm_cvttps_epi32(_mm_add_ps(_mm_min_ps(_mm_max_ps(sum, _mm_setzero_ps()), alpha), half));
+        const __m128i packed = _mm_packs_epi32(channels, channels);
+        dest[x] = QRgb(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+    }
+}
+
+BEZIER_TARGET_AVX2 void bicubicRowAVX2(const RotationParams& p, const int& y, int x, const int& end)
+{
+    QRgb* dest = p.dest + y * p.destStride;
+    const int Y = y - p.centerY;
+    const float baseX = p.sin * Y + (p.centerX - p.left);
+    const float baseY = p.cos * Y + (p.centerY - p.top);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256 full = _mm256_set1_ps(255.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    // two pixels at a time, one in each half of the vectors, with their channels in the four lanes of the half
+    for (; x + 2 <= end; x += 2)
+    {
+        int X0[2];
+        int Y0[2];
+        float wx[2][4];
+        float wy[2][4];
+        bool isInside[2];
+        for (int k = 0; k < 2; k++)
+        {
+            const int X = x + k - p.centerX;
+            const float sx = p.cos * X + baseX;
+            const float sy = baseY - p.sin * X;
+            X0[k] = floorToInt(sx);
+            Y0[k] = floorToInt(sy);
+            cubicWeights(sx - X0[k], wx[k]);
+            cubicWeights(sy - Y0[k], wy[k]);
+            isInside[k] = X0[k] >= 1 && X0[k] + 2 < p.width && Y0[k] >= 1 && Y0[k] + 2 < p.height;
+        }
+        const __m256 wx0 = _mm256_setr_ps(wx[0][0], wx[0][0], wx[0][0], wx[0][0], wx[1][0], wx[1][0], wx[1][0], wx[1][0]);
+        const __m256 wx1 = _mm256_setr_ps(wx[0][1], wx[0][1], wx[0][1], wx[0][1], wx[1][1], wx[1][1], wx[1][1], wx[1][1]);
+        const __m256 wx2 = _mm256_setr_ps(wx[0][2], wx[0][2], wx[0][2], wx[0][2], wx[1][2], wx[1][2], wx[1][2], wx[1][2]);
+        const __m256 wx3 = _mm256_setr_ps(wx[0][3], wx[0][3], wx[0][3], wx[0][3], wx[1][3], wx[1][3], wx[1][3], wx[1][3]);
+        __m256 sum = _mm256_setzero_ps();
+        for (int j = 0; j < 4; j++)
+        {
+            __m128i taps[2];
+            for (int k = 0; k < 2; k++)
             {
-                QVector3D curr = (1.0f - f) * QVector3D(currCol.red(), currCol.green(), currCol.blue());
-                QVector3D down = f * QVector3D(downCol.red(), downCol.green(), downCol.blue());
-                sum = QColor(curr.x() + down.x(), curr.y() + down.y(), curr.z() + down.z());
+                const int row = Y0[k] - 1 + j;
+                taps[k] = isInside[k]
+                    ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(p.sour + row * p.sourStride + X0[k] - 1))
+                    : _mm_setr_epi32(int(sourcePixel(p, X0[k] - 1, row)), int(sourcePixel(p, X0[k], row)),
+                                     int(sourcePixel(p, X0[k] + 1, row)), int(sourcePixel(p, X0[k] + 2, row)));
             }
-            dest.setPixelColor(x, newY, sum);
+            const __m256i both = _mm256_inserti128_si256(_mm256_castsi128_si256(taps[0]), taps[1], 1);
+            const __m256i lo = _mm256_unpacklo_epi8(both, zero);
+            const __m256i hi = _mm256_unpackhi_epi8(both, zero);
+            __m256 row = _mm256_mul_ps(wx0, _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(lo, zero)));
+            row = _mm256_add_ps(row, _mm256_mul_ps(wx1, _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(lo, zero))));
+            row = _mm256_add_ps(row, _mm256_mul_ps(wx2, _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(hi, zero))));
+            row = _mm256_add_ps(row, _mm256_mul_ps(wx3, _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(hi, zero))));
+            const __m256 wyj = _mm256_setr_ps(wy[0][j], wy[0][j], wy[0][j], wy[0][j], wy[1][j], wy[1][j], wy[1][j], wy[1][j]);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(wyj, row));
         }
-        const int newY = dy + size.height() - 1;
-        if (newY >= 0 && newY < size.height())
+        const __m256 alpha = _mm256_min_ps(_mm256_max_ps(_mm256_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 3, 3)), _mm256_setzero_ps()), full);
+        const __m256i channels = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(sum, _mm256_setzero_ps()), alpha), half));
+        const __m256i packed = _mm256_packs_epi32(channels, channels);
+        const __m256i bytes = _mm256_packus_epi16(packed, packed);
+        dest[x] = QRgb(_mm_cvtsi128_si32(_mm256_castsi256_si128(bytes)));
+        dest[x + 1] = QRgb(_mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1)));
+    }
+    bicubicRowScalar(p, y, x, end);
+}
+#endif
+
+/*!
+ * \brief The side of the square tiles the quarter turns are blocked into, 4 KiB of pixels per tile
+ */
+constexpr int TileSize = 32;
+
+/*!
+ * \brief Calls a function for every row of a range on the shared executor, in tiles of rows sized to the cache.
+ * \param count The number of rows, the range is [0, count).
+ * \param rowBytes The number of bytes a row reads and writes.
+ * \param function The callable taking the row.
+ */
+template <typename Function>
+void forEachRow(const int& count, const qsizetype& rowBytes, const Function& function)
+{
+    Executor& executor = Executor::instance();
+    executor.forRange(count, executor.rowGrain(rowBytes), [&function](const int& begin, const int& end) {
+        for (int y = begin; y < end; y++)
         {
-            dest.setPixelColor(x, newY, sour.pixelColor(x, size.height() - 1));
+            function(y);
         }
     });
 }
 
-void TurnImage_90(QImage& dest, QImage& sour, const std::vector<int>& xs)
+/*!
+ * \brief Calls a kernel for every tile of an area, one row of tiles per chunk.
+ * \param size The size of the area.
+ * \param kernel The callable taking the tile bounds (x0, y0, x1, y1), with the ends exclusive.
+ */
+template <typename Kernel>
+void forEachTile(const QSize& size, const Kernel& kernel)
 {
-    QtConcurrent::blockingMap(xs, [&dest, &sour](const int& x) {
-        for (int y = 0; y < dest.height(); y++)
+    Executor::instance().forRange((size.height() + TileSize - 1) / TileSize, 1, [&size, &kernel](const int& begin, const int& end) {
+        for (int row = begin; row < end; row++)
         {
-            dest.setPixelColor(x, y, sour.pixelColor(x, sour.height() - 1 - y));
+            const int y0 = row * TileSize;
+            const int y1 = qMin(y0 + TileSize, size.height());
+            for (int x0 = 0; x0 < size.width(); x0 += TileSize)
+            {
+                kernel(x0, y0, qMin(x0 + TileSize, size.width()), y1);
+            }
         }
     });
-    QtConcurrent::blockingMap(xs, [&dest, &sour](const int& x) {
-        for (int y = 0; y < sour.height(); y++)
+}
+
+ShearRowKernel shearRowKernel()
+{
+#if defined(BEZIER_SIMD_X86)
+    switch (simdLevel())
+    {
+        case SimdLevel::AVX2:
         {
-            sour.setPixelColor(x, y, dest.pixelColor(y, x));
+            return shearRowAVX2;
         }
-    });
+        case SimdLevel::SSE2:
+        {
+            return shearRowSSE2;
+        }
+        default:
+        {
+            break;
+        }
+    }
+#endif
+    return shearRowScalar;
+}
+
+ShearColumnsKernel shearColumnsKernel()
+{
+#if defined(BEZIER_SIMD_X86)
+    switch (simdLevel())
+    {
+        case SimdLevel::AVX2:
+        {
+            return shearColumnsAVX2;
+        }
+        case SimdLevel::SSE2:
+        {
+            return shearColumnsSSE2;
+        }
+        default:
+        {
+            break;
+        }
+    }
+#endif
+    return shearColumnsScalar;
+}
 
-    dest = sour;
+RotationRowKernel bilinearRowKernel()
+{
+#if defined(BEZIER_SIMD_X86)
+    switch (simdLevel())
+    {
+        case SimdLevel::AVX2:
+        {
+            return bilinearRowAVX2;
+        }
+        case SimdLevel::SSE2:
+        {
+            return bilinearRowSSE2;
+        }
+        default:
+        {
+            break;
+        }
+    }
+#endif
+    return bilinearRowScalar;
+}
+
+RotationRowKernel bicubicRowKernel()
+{
+#if defined(BEZIER_SIMD_X86)
+    switch (simdLevel())
+    {
+        case SimdLevel::AVX2:
+        {
+            return bicubicRowAVX2;
+        }
+        case SimdLevel::SSE2:
+        {
+            return bicubicRowSSE2;
+        }
+        default:
+        {
+            break;
+        }
+    }
+#endif
+    return bicubicRowScalar;
 }
 
-void TurnImage_180(QImage& dest, QImage& sour, const std::vector<int>& xs)
+/*!
+ * \brief Runs a rotation kernel over the footprint of the rotated source only.
+ * Every row gets the span of columns whose inverse mapping can reach the source, the pixels of the bounding
+ * rectangle off the span of their row are cleared, and the ones outside of it are never touched.
+ * \param dest The destination image.
+ * \param params The parameters of the rotation.
+ * \param placed Where the source lies in the destination before the rotation.
+ * \param reach How many pixels past the edges of the source the kernel still reads it.
+ * \param kernel The row kernel.
+ * \param arena The arena providing the span table.
+ * \return The bounding rectangle of the footprint.
+ */
+QRect rotateFootprint(QImage& dest, const RotationParams& params, const QRect& placed, const int& reach, const RotationRowKernel& kernel, FrameArena& arena)
 {
-    QtConcurrent::blockingMap(xs, [&dest, &sour](const int& x) {
-        for (int y = 0; y < dest.height(); y++)
+    // a pixel of slack on either side covers the rounding of the float mapping, the kernels still check
+    // every pixel, so the spans only have to cover them
+    const double lo = -1 - reach;
+    const double hi = reach;
+    std::vector<int>& spans = arena.table(FrameArena::Table::Spans, 2 * dest.height());
+    int left = dest.width();
+    int right = 0;
+    int top = dest.height();
+    int bottom = 0;
+    for (int y = 0; y < dest.height(); y++)
+    {
+        const int Y = y - params.centerY;
+        double from = -params.centerX;
+        double to = dest.width() - 1 - params.centerX;
+        clipToBand(params.cos, double(params.sin) * Y + params.centerX, placed.left() + lo, placed.left() + placed.width() + hi, from, to);
+        clipToBand(-params.sin, double(params.cos) * Y + params.centerY, placed.top() + lo, placed.top() + placed.height() + hi, from, to);
+        if (from > to)
         {
-            dest.setPixelColor(x, y, sour.pixelColor(x, sour.height() - 1 - y));
+            spans[2 * y] = spans[2 * y + 1] = -1;
+            continue;
         }
+        spans[2 * y] = qCeil(from) + params.centerX;
+        spans[2 * y + 1] = qFloor(to) + params.centerX + 1;
+        left = qMin(left, spans[2 * y]);
+        right = qMax(right, spans[2 * y + 1]);
+        top = qMin(top, y);
+        bottom = qMax(bottom, y + 1);
+    }
+    if (left >= right) { return QRect(); }
+
+    const QRect rect(left, top, right - left, bottom - top);
+    forEachRow(rect.height(), 2 * rect.width() * qsizetype(sizeof(QRgb)), [&params, &kernel, &spans, &rect](const int& i) {
+        const int y = rect.top() + i;
+        QRgb* dest = params.dest + y * params.destStride;
+        const int begin = spans[2 * y] < 0 ? rect.left() : spans[2 * y];
+        const int end = spans[2 * y] < 0 ? rect.left() : spans[2 * y + 1];
+        std::fill(dest + rect.left(), dest + begin, 0);
+        kernel(params, y, begin, end);
+        std::fill(dest + end, dest + rect.left() + rect.width(), 0);
     });
-    QtConcurrent::blockingMap(xs, [&dest, &sour](const int& x) {
-        for (int y = 0; y < sour.height(); y++)
+    return rect;
+}
+
+/*!
+ * \brief Rotates an image through a filtering kernel, sampling the premultiplied source.
+ * \param dest The destination image, left in Format_ARGB32_Premultiplied.
+ * \param sour The source image.
+ * \param theta The rotation angle in radians.
+ * \param offset The offset for the rotation.
+ * \param reach How many pixels past the edges of the source the kernel still reads it.
+ * \param kernel The row kernel.
+ * \param arena The arena providing the scratch buffers.
+ * \return The bounding rectangle of the rotated source.
+ */
+QRect filteredRotation(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, const int& reach,
+                       const RotationRowKernel& kernel, FrameArena& arena)
+{
+    // the filters blend neighbouring pixels, which only weights alpha correctly on premultiplied ones,
+    // so the source is premultiplied once, in a scratch image of its own size rather than the padded one
+    const QRect placed(QPoint(offset, offset), dest.size() - 2 * QSize(offset, offset));
+    const QImage* source = sour.data();
+    const bool isPremultiplied = sour->format() == QImage::Format_ARGB32_Premultiplied || sour->format() == QImage::Format_RGB32;
+    if (!isPremultiplied || sour->size() != placed.size())
+    {
+        QImage& temp = arena.image(FrameArena::Image::Temp, placed.size(), QImage::Format_ARGB32_Premultiplied);
+        Sour2Dest(temp, *sour, 0);
+        source = &temp;
+    }
+    dest.reinterpretAsFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const RotationParams params {
+        reinterpret_cast<const QRgb*>(source->constScanLine(0)),
+        source->bytesPerLine() / qsizetype(sizeof(QRgb)),
+        reinterpret_cast<QRgb*>(dest.scanLine(0)),
+        dest.bytesPerLine() / qsizetype(sizeof(QRgb)),
+        source->width(),
+        source->height(),
+        placed.left(),
+        placed.top(),
+        sour->width(),
+        sour->height(),
+        float(qCos(theta)),
+        float(qSin(theta))
+    };
+    return rotateFootprint(dest, params, placed, reach, kernel, arena);
+}
+}
+
+QRect Rotate(QImage& dest, const QSharedPointer<QImage>& sour, const Algorithm::Enum& algorithm, const float& theta, const int& offset, FrameArena& arena)
+{
+    switch (algorithm)
+    {
+        case Algorithm::Enum::Naive:
         {
-            sour.setPixelColor(x, y, dest.pixelColor(dest.width() - 1 - x, y));
+            return Naive(dest, sour, theta, offset, arena);
         }
+        case Algorithm::Enum::Bilinear:
+        {
+            return Bilinear(dest, sour, theta, offset, arena);
+        }
+        case Algorithm::Enum::Bicubic:
+        {
+            return Bicubic(dest, sour, theta, offset, arena);
+        }
+        default:
+        {
+            break;
+        }
+    }
+    Shear(dest, sour, theta, offset, arena);
+    return dest.rect();
+}
+
+QRect Naive(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena)
+{
+    // the common formats are read in place, anything else is first placed in the padded scratch image
+    const QRect placed(QPoint(offset, offset), dest.size() - 2 * QSize(offset, offset));
+    const QImage* source = sour.data();
+    QPoint origin = placed.topLeft();
+    const bool isDirect = sour->depth() == 32 && (sour->format() == dest.format() || sour->format() == QImage::Format_RGB32)
+                          && sour->size() == placed.size();
+    if (!isDirect)
+    {
+        QImage& temp = arena.image(FrameArena::Image::Temp, dest.size(), dest.format());
+        Sour2Dest(temp, *sour, offset);
+        source = &temp;
+        origin = QPoint(0, 0);
+    }
+    const float sin = qSin(theta);
+    const float cos = qCos(theta);
+
+    const RotationParams params {
+        reinterpret_cast<const QRgb*>(source->constScanLine(0)),
+        source->bytesPerLine() / qsizetype(sizeof(QRgb)),
+        reinterpret_cast<QRgb*>(dest.scanLine(0)),
+        dest.bytesPerLine() / qsizetype(sizeof(QRgb)),
+        source->width(),
+        source->height(),
+        origin.x(),
+        origin.y(),
+        sour->width(),
+        sour->height(),
+        cos,
+        sin
+    };
+    // the truncated mapping reads the source up to a pixel before its edges
+    return rotateFootprint(dest, params, placed, 1, naiveRowKernel(), arena);
+}
+
+QRect Bilinear(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena)
+{
+    // the right and lower taps reach a pixel before the edges
+    return filteredRotation(dest, sour, theta, offset, 1, bilinearRowKernel(), arena);
+}
+
+QRect Bicubic(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena)
+{
+    // the outer taps reach two pixels before the edges
+    return filteredRotation(dest, sour, theta, offset, 2, bicubicRowKernel(), arena);
+}
+
+void Shear(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena)
+{
+    // the shear passes blend linearly, which only weights alpha correctly on premultiplied pixels
+    QImage& temp = arena.image(FrameArena::Image::Temp, dest.size(), QImage::Format_ARGB32_Premultiplied);
+    Sour2Dest(temp, *sour, offset);
+    dest.reinterpretAsFormat(QImage::Format_ARGB32_Premultiplied);
+
+    float phi = theta;
+    if (theta >= 3 * M_PI / 2) {
+        phi = theta - 3 * M_PI / 2;
+        TurnImage_270(dest, temp);
+        temp.swap(dest);
+    }
+    else if (theta >= M_PI)
+    {
+        phi = theta - M_PI;
+        TurnImage_180(dest, temp);
+        temp.swap(dest);
+    }
+    else if (theta >= M_PI / 2)
+    {
+        phi = theta - M_PI / 2;
+        TurnImage_90(dest, temp);
+        temp.swap(dest);
+    }
+
+    const float sin = qSin(phi);
+    const float tan = -qTan(phi / 2);
+
+    ShearX(dest, temp, tan);
+    ShearY(temp, dest, sin, arena);
+    ShearX(dest, temp, tan);
+}
+
+void ShearX(QImage& dest, QImage& sour, const float& lambda)
+{
+    const ShearParams params {
+        reinterpret_cast<const QRgb*>(sour.constScanLine(0)),
+        sour.bytesPerLine() / qsizetype(sizeof(QRgb)),
+        reinterpret_cast<QRgb*>(dest.scanLine(0)),
+        dest.bytesPerLine() / qsizetype(sizeof(QRgb)),
+        dest.width(),
+        dest.height()
+    };
+    const ShearRowKernel kernel = shearRowKernel();
+    const int center = sour.height() / 2;
+
+    forEachRow(params.height, 2 * params.width * qsizetype(sizeof(QRgb)), [&params, &kernel, &lambda, &center](const int& y) {
+        const float ly = lambda * (y - center);
+        const int dx = qFloor(ly);
+        kernel(params, y, dx, shearWeight(ly - dx));
     });
+}
+
+void ShearY(QImage& dest, QImage& sour, const float& lambda, FrameArena& arena)
+{
+    const ShearParams params {
+        reinterpret_cast<const QRgb*>(sour.constScanLine(0)),
+        sour.bytesPerLine() / qsizetype(sizeof(QRgb)),
+        reinterpret_cast<QRgb*>(dest.scanLine(0)),
+        dest.bytesPerLine() / qsizetype(sizeof(QRgb)),
+        dest.width(),
+        dest.height()
+    };
+    const ShearColumnsKernel kernel = shearColumnsKernel();
 
-    dest = sour;
+    // every column gets its own shift, so they are tabulated once and the image is then walked row by row
+    int* shifts = arena.table(FrameArena::Table::Shifts, params.width).data();
+    int* weights = arena.table(FrameArena::Table::Weights, params.width).data();
+    const int center = sour.width() / 2;
+    for (int x = 0; x < params.width; x++)
+    {
+        const float lx = lambda * (x - center);
+        shifts[x] = qFloor(lx);
+        weights[x] = shearWeight(lx - shifts[x]);
+    }
+
+    forEachRow(params.height, 2 * params.width * qsizetype(sizeof(QRgb)), [&params, &kernel, &shifts, &weights](const int& y) {
+        kernel(params, y, shifts, weights);
+    });
 }
 
-void TurnImage_270(QImage& dest, QImage& sour, const std::vector<int>& xs)
+void TurnImage_90(QImage& dest, const QImage& sour)
 {
-    QtConcurrent::blockingMap(xs, [&dest, &sour](const int& x) {
-        for (int y = 0; y < dest.height(); y++)
+    const QRgb* s = reinterpret_cast<const QRgb*>(sour.constScanLine(0));
+    const qsizetype sourStride = sour.bytesPerLine() / qsizetype(sizeof(QRgb));
+    QRgb* d = reinterpret_cast<QRgb*>(dest.scanLine(0));
+    const qsizetype destStride = dest.bytesPerLine() / qsizetype(sizeof(QRgb));
+    const int last = sour.height() - 1;
+
+    forEachTile(dest.size(), [&](const int& x0, const int& y0, const int& x1, const int& y1) {
+        for (int y = y0; y < y1; y++)
         {
-            dest.setPixelColor(x, y, sour.pixelColor(y, x));
+            QRgb* row = d + y * destStride;
+            for (int x = x0; x < x1; x++)
+            {
+                row[x] = s[(last - x) * sourStride + y];
+            }
         }
     });
-    QtConcurrent::blockingMap(xs, [&dest, &sour](const int& x) {
-        for (int y = 0; y < sour.height(); y++)
+}
+
+void TurnImage_180(QImage& dest, const QImage& sour)
+{
+    const QRgb* s = reinterpret_cast<const QRgb*>(sour.constScanLine(0));
+    const qsizetype sourStride = sour.bytesPerLine() / qsizetype(sizeof(QRgb));
+    QRgb* d = reinterpret_cast<QRgb*>(dest.scanLine(0));
+    const qsizetype destStride = dest.bytesPerLine() / qsizetype(sizeof(QRgb));
+    const int width = dest.width();
+    const int last = sour.height() - 1;
+
+    // a half turn keeps rows intact, so every row is one reversed copy of its mirror
+    forEachTile(QSize(1, dest.height()), [&](const int&, const int& y0, const int&, const int& y1) {
+        for (int y = y0; y < y1; y++)
         {
-            sour.setPixelColor(x, y, dest.pixelColor(x, dest.height() - 1 - y));
+            const QRgb* row = s + (last - y) * sourStride;
+            std::reverse_copy(row, row + width, d + y * destStride);
         }
     });
+}
+
+void TurnImage_270(QImage& dest, const QImage& sour)
+{
+    const QRgb* s = reinterpret_cast<const QRgb*>(sour.constScanLine(0));
+    const qsizetype sourStride = sour.bytesPerLine() / qsizetype(sizeof(QRgb));
+    QRgb* d = reinterpret_cast<QRgb*>(dest.scanLine(0));
+    const qsizetype destStride = dest.bytesPerLine() / qsizetype(sizeof(QRgb));
+    const int last = sour.width() - 1;
 
-    dest = sour;
+    forEachTile(dest.size(), [&](const int& x0, const int& y0, const int& x1, const int& y1) {
+        for (int y = y0; y < y1; y++)
+        {
+            QRgb* row = d + y * destStride;
+            const QRgb* column = s + (last - y);
+            for (int x = x0; x < x1; x++)
+            {
+                row[x] = column[x * sourStride];
+            }
+        }
+    });
 }
 
-QImage Sour2Dest(const QSize& size, const QImage& sour, const int& offset)
+void Sour2Dest(QImage& dest, const QImage& sour, const int& offset)
 {
-    QImage temp(size, QImage::Format_ARGB32);
-    temp.fill(QColor(0, 0, 0, 0));
-    QPainter painter(&temp);
-    painter.drawImage(QRect(
-                          QPoint(offset, offset),
-                          QPoint(size.width() - offset, size.height() - offset)),
-                      sour);
-    return temp;
+    const QRect rect(QPoint(offset, offset), dest.size() - 2 * QSize(offset, offset));
+    dest.fill(Qt::transparent);
+    const bool isCopy = sour.format() == dest.format() || sour.format() == QImage::Format_RGB32;
+    const bool isPremultiplied = sour.format() == QImage::Format_ARGB32 && dest.format() == QImage::Format_ARGB32_Premultiplied;
+    if (rect.size() != sour.size() || dest.depth() != 32 || (!isCopy && !isPremultiplied))
+    {
+        // scaling or an unusual format, which the raster engine handles
+        QPainter painter(&dest);
+        painter.drawImage(rect, sour);
+        return;
+    }
+    // the common case is a plain blit, row by row, without a painter
+    for (int y = 0; y < sour.height(); y++)
+    {
+        const QRgb* from = reinterpret_cast<const QRgb*>(sour.constScanLine(y));
+        QRgb* to = reinterpret_cast<QRgb*>(dest.scanLine(rect.top() + y)) + rect.left();
+        if (isCopy)
+        {
+            std::copy(from, from + sour.width(), to);
+        }
+        else
+        {
+            std::transform(from, from + sour.width(), to, [](const QRgb& pixel) { return qPremultiply(pixel); });
+        }
+    }
 }
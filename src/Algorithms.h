@@ -2,65 +2,103 @@
 
 #include <QSharedPointer>
 #include <QImage>
+#include <QRect>
+
+#include "Enums.h"
+#include "FrameArena.h"
 
+/*!
+ * \brief Rotates an image with the chosen algorithm.
+ * \param dest The destination image.
+ * \param sour The source image.
+ * \param algorithm The rotation algorithm.
+ * \param theta The rotation angle in radians.
+ * \param offset The offset for the rotation.
+ * \param arena The arena providing the scratch buffers.
+ * \return The part of the destination holding the sprite, the pixels outside of it are undefined.
+ */
+QRect Rotate(QImage& dest, const QSharedPointer<QImage>& sour, const Algorithm::Enum& algorithm, const float& theta, const int& offset, FrameArena& arena);
 /*!
  * \brief Performs a naive rotation on image.
+ * Only the pixels of every row that the rotated source covers are transformed, the rest of the bounding
+ * rectangle is cleared and the destination outside of it is left untouched.
+ * \param dest The destination image.
+ * \param sour The source image.
+ * \param theta The rotation angle in radians.
+ * \param offset The offset for the rotation.
+ * \param arena The arena providing the scratch buffers.
+ * \return The bounding rectangle of the rotated source, the pixels outside of it are undefined.
+ */
+QRect Naive(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena);
+/*!
+ * \brief Performs a bilinearly filtered rotation on image, in a single inverse-mapped pass.
+ * The source is filtered in premultiplied space, so the destination is left in Format_ARGB32_Premultiplied.
  * \param dest The destination image.
  * \param sour The source image.
  * \param theta The rotation angle in radians.
  * \param offset The offset for the rotation.
+ * \param arena The arena providing the scratch buffers.
+ * \return The bounding rectangle of the rotated source, the pixels outside of it are undefined.
  */
-void Naive(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset);
+QRect Bilinear(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena);
+/*!
+ * \brief Performs a bicubically (Catmull-Rom) filtered rotation on image, in a single inverse-mapped pass.
+ * The source is filtered in premultiplied space, so the destination is left in Format_ARGB32_Premultiplied.
+ * \param dest The destination image.
+ * \param sour The source image.
+ * \param theta The rotation angle in radians.
+ * \param offset The offset for the rotation.
+ * \param arena The arena providing the scratch buffers.
+ * \return The bounding rectangle of the rotated source, the pixels outside of it are undefined.
+ */
+QRect Bicubic(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena);
 /*!
  * \brief Performs a triple shear rotation on image.
+ * The passes blend in premultiplied space, so the destination is left in Format_ARGB32_Premultiplied.
  * \param dest The destination image.
  * \param sour The source image.
  * \param theta The rotation angle in radians.
  * \param offset The offset for the rotation.
+ * \param arena The arena providing the scratch buffers.
  */
-void Shear(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset);
+void Shear(QImage& dest, const QSharedPointer<QImage>& sour, const float& theta, const int& offset, FrameArena& arena);
 /*!
  * \brief Performs a shear transformation along the x-axis on image.
  * \param dest The destination image.
  * \param sour The source image.
  * \param lambda The shear factor.
- * \param ys The y-coordinates of the image.
  */
-void ShearX(QImage& dest, QImage& sour, const float& lambda, const std::vector<int>& ys);
+void ShearX(QImage& dest, QImage& sour, const float& lambda);
 /*!
  * \brief Performs a shear transformation along the y-axis on image.
  * \param dest The destination image.
  * \param sour The source image.
  * \param lambda The shear factor.
- * \param xs The x-coordinates of the image.
+ * \param arena The arena providing the column tables.
  */
-void ShearY(QImage& dest, QImage& sour, const float& lambda, const std::vector<int>& xs);
+void ShearY(QImage& dest, QImage& sour, const float& lambda, FrameArena& arena);
 /*!
- * \brief Rotates an image by 90 degrees.
- * \param dest The destination image.
+ * \brief Rotates an image by 90 degrees in a single cache-blocked pass.
+ * \param dest The destination image, must not share data with the source.
  * \param sour The source image.
- * \param xs The x-coordinates of the image.
  */
-void TurnImage_90(QImage& dest, QImage& sour, const std::vector<int>& xs);
+void TurnImage_90(QImage& dest, const QImage& sour);
 /*!
- * \brief Rotates an image by 180 degrees.
- * \param dest The destination image.
+ * \brief Rotates an image by 180 degrees in a single cache-blocked pass.
+ * \param dest The destination image, must not share data with the source.
  * \param sour The source image.
- * \param xs The x-coordinates of the image.
  */
-void TurnImage_180(QImage& dest, QImage& sour, const std::vector<int>& xs);
+void TurnImage_180(QImage& dest, const QImage& sour);
 /*!
- * \brief Rotates an image by 270 degrees.
- * \param dest The destination image.
+ * \brief Rotates an image by 270 degrees in a single cache-blocked pass.
+ * \param dest The destination image, must not share data with the source.
  * \param sour The source image.
- * \param xs The x-coordinates of the image.
  */
-void TurnImage_270(QImage& dest, QImage& sour, const std::vector<int>& xs);
+void TurnImage_270(QImage& dest, const QImage& sour);
 /*!
- * \brief Places a source image in the center of larger destination image.
- * \param size The size of the destination image.
+ * \brief Places a source image in the center of larger destination image, clearing the rest of it.
+ * \param dest The destination image, premultiplied or not.
  * \param sour The source image.
  * \param offset The offset for the conversion.
- * \return The destination image.
  */
-QImage Sour2Dest(const QSize& size, const QImage& sour, const int& offset);
+void Sour2Dest(QImage& dest, const QImage& sour, const int& offset);
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "Bernstein.h"
+#include "Simd.h"
+
+namespace
+{
+/*!
+ * \brief Computes a row of the Pascal triangle at compile time.
+ * \return The binomial coefficients C(N, 0) ... C(N, N), every one of them exact in double.
+ */
+template<int N>
+constexpr std::array<double, N + 1> binomials()
+{
+    std::array<double, N + 1> row {};
+    row[0] = 1.0;
+    for (int k = 1; k <= N; k++)
+    {
+        row[k] = row[k - 1] * (N - k + 1) / k;
+    }
+    return row;
+}
+
+/*!
+ * \brief Evaluates all Bernstein polynomials of the degree N at a parameter.
+ * The degrees handled here are small enough for the plain product of the binomial coefficient and the powers
+ * to stay accurate, so the values are formed directly.
+ * \param t The parameter in [0, 1].
+ * \param basis The array receiving the N + 1 values.
+ */
+template<int N>
+void BernsteinOf(const int&, const double& t, float* basis)
+{
+    static constexpr std::array<double, N + 1> binomial = binomials<N>();
+    // the powers of t rise and the powers of 1 - t fall along the row, both are tabulated once
+    const double s = 1.0 - t;
+    std::array<double, N + 1> rising;
+    std::array<double, N + 1> falling;
+    rising[0] = 1.0;
+    falling[N] = 1.0;
+    for (int k = 1; k <= N; k++)
+    {
+        rising[k] = rising[k - 1] * t;
+        falling[N - k] = falling[N - k + 1] * s;
+    }
+    for (int k = 0; k <= N; k++)
+    {
+        basis[k] = binomial[k] * rising[k] * falling[k];
+    }
+}
+
+/*!
+ * \brief Builds the table of the evaluators compiled for the degrees 0 ... BernsteinDegrees.
+ * \return The table indexed by the degree.
+ */
+template<int... N>
+constexpr std::array<BernsteinFunction, sizeof...(N)> evaluators(std::integer_sequence<int, N...>)
+{
+    return { &BernsteinOf<N>... };
+}
+
+const std::array<BernsteinFunction, BernsteinDegrees + 1> Evaluators = evaluators(std::make_integer_sequence<int, BernsteinDegrees + 1>());
+
+/*!
+ * \brief Evaluates all Bernstein polynomials of a degree at a run of samples, one sample at a time.
+ * \param n The degree.
+ * \param first The index of the first sample.
+ * \param end The index past the last sample.
+ * \param samples The number of samples of the curve.
+ * \param columns The column-major table of the values.
+ */
+void BernsteinColumns(const int& n, const int& first, const int& end, const int& samples, float* columns)
+{
+    std::vector<float> row(n + 1);
+    for (int i = first; i < end; i++)
+    {
+        Bernstein(n, static_cast<double>(i) / samples, row.data());
+        for (int k = 0; k <= n; k++)
+        {
+            columns[k * samples + i] = row[k];
+        }
+    }
+}
+
+// The vector kernels below evaluate exactly the same double expressions as BernsteinOf, lane by lane,
+// so every sample gets the same values whichever kernel runs.
+
+template<int N>
+void BernsteinColumnsScalar(const int&, const int& first, const int& end, const int& samples, float* columns)
+{
+    std::array<float, N + 1> row;
+    for (int i = first; i < end; i++)
+    {
+        BernsteinOf<N>(N, static_cast<double>(i) / samples, row.data());
+        for (int k = 0; k <= N; k++)
+        {
+            columns[k * samples + i] = row[k];
+        }
+    }
+}
+
+#if defined(BEZIER_SIMD_X86)
+template<int N>
+BEZIER_TARGET_SSE2 void BernsteinColumnsSSE2(const int& n, const int& first, const int& end, const int& samples, float* columns)
+{
+    static constexpr std::array<double, N + 1> binomial = binomials<N>();
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d count = _mm_set1_pd(samples);
+    int i = first;
+    for (; i + 2 <= end; i += 2)
+    {
+        // the indices are exact in double, so the division rounds like the one of a single sample
+        const __m128d t = _mm_div_pd(_mm_set_pd(i + 1, i), count);
+        const __m128d s = _mm_sub_pd(one, t);
+        __m128d rising[N + 1];
+        __m128d falling[N + 1];
+        rising[0] = one;
+        falling[N] = one;
+        for (int k = 1; k <= N; k++)
+        {
+            rising[k] = _mm_mul_pd(rising[k - 1], t);
+            falling[N - k] = _mm_mul_pd(falling[N - k + 1], s);
+        }
+        for (int k = 0; k <= N; k++)
+        {
+            const __m128 values = _mm_cvtpd_ps(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(binomial[k]), rising[k]), falling[k]));
+            _mm_storel_pi(reinterpret_cast<__m64*>(columns + k * samples + i), values);
+        }
+    }
+    BernsteinColumnsScalar<N>(n, i, end, samples, columns);
+}
+
+template<int N>
+BEZIER_TARGET_AVX2 void BernsteinColumnsAVX2(const int& n, const int& first, const int& end, const int& samples, float* columns)
+{
+    static constexpr std::array<double, N + 1> binomial = binomials<N>();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d count = _mm256_set1_pd(samples);
+    int i = first;
+    for (; i + 4 <= end; i += 4)
+    {
+        const __m256d t = _mm256_div_pd(_mm256_set_pd(i + 3, i + 2, i + 1, i), count);
+        const __m256d s = _mm256_sub_pd(one, t);
+        __m256d rising[N + 1];
+        __m256d falling[N + 1];
+        rising[0] = one;
+        falling[N] = one;
+        for (int k = 1; k <= N; k++)
+        {
+            rising[k] = _mm256_mul_pd(rising[k - 1], t);
+            falling[N - k] = _mm256_mul_pd(falling[N - k + 1], s);
+        }
+        for (int k = 0; k <= N; k++)
+        {
+            const __m128 values = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(binomial[k]), rising[k]), falling[k]));
+            _mm_storeu_ps(columns + k * samples + i, values);
+        }
+    }
+    BernsteinColumnsScalar<N>(n, i, end, samples, columns);
+}
+#endif
+
+/*!
+ * \brief Builds the tables of the column evaluators compiled for the degrees 0 ... BernsteinDegrees.
+ * \return The tables indexed by the instruction set and the degree.
+ */
+template<int... N>
+constexpr std::array<std::array<BernsteinColumnsFunction, sizeof...(N)>, 3> columnEvaluators(std::integer_sequence<int, N...>)
+{
+#if defined(BEZIER_SIMD_X86)
+    return { { { &BernsteinColumnsScalar<N>... }, { &BernsteinColumnsSSE2<N>... }, { &BernsteinColumnsAVX2<N>... } } };
+#else
+    return { { { &BernsteinColumnsScalar<N>... }, { &BernsteinColumnsScalar<N>... }, { &BernsteinColumnsScalar<N>... } } };
+#endif
+}
+
+const std::array<std::array<BernsteinColumnsFunction, BernsteinDegrees + 1>, 3> ColumnEvaluators =
+    columnEvaluators(std::make_integer_sequence<int, BernsteinDegrees + 1>());
+}
+
+void Bernstein(const int& n, const double& t, float* basis)
+{
+    if (t <= 0.0 || t >= 1.0)
+    {
+        std::fill(basis, basis + n + 1, 0.0f);
+        basis[t <= 0.0 ? 0 : n] = 1.0f;
+        return;
+    }
+    // the polynomials of a degree form a binomial distribution, which peaks at its mode
+    const int mode = std::clamp(static_cast<int>(std::floor((n + 1) * t)), 0, n);
+    const double peak = std::exp(std::lgamma(n + 1.0) - std::lgamma(mode + 1.0) - std::lgamma(n - mode + 1.0)
+                                 + mode * std::log(t) + (n - mode) * std::log1p(-t));
+    const double ratio = t / (1.0 - t);
+
+    // away from the mode the values only decrease, and fade out to zero instead of underflowing early
+    double value = peak;
+    basis[mode] = value;
+    for (int i = mode; i < n; i++)
+    {
+        value *= (n - i) / (i + 1.0) * ratio;
+        basis[i + 1] = value;
+    }
+    value = peak;
+    for (int i = mode; i > 0; i--)
+    {
+        value *= i / ((n - i + 1.0) * ratio);
+        basis[i - 1] = value;
+    }
+}
+
+BernsteinFunction BernsteinEvaluator(const int& n)
+{
+    if (n >= 0 && n <= BernsteinDegrees) { return Evaluators[n]; }
+    return &Bernstein;
+}
+
+BernsteinColumnsFunction BernsteinColumnsEvaluator(const int& n)
+{
+    if (n >= 0 && n <= BernsteinDegrees) { return ColumnEvaluators[static_cast<int>(simdLevel())][n]; }
+    return &BernsteinColumns;
+}
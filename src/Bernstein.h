@@ -0,0 +1,51 @@
+#pragma once
+
+/*!
+ * \brief Evaluates all Bernstein polynomials of a degree at a parameter.
+ * The largest polynomial is computed in logarithmic space and the others follow from the ratios of
+ * their neighbours, in double precision, so no binomial coefficient or power is ever formed and
+ * the values neither overflow nor lose precision at any degree.
+ * \param n The degree.
+ * \param t The parameter in [0, 1].
+ * \param basis The array receiving the n + 1 values B_0,n(t) ... B_n,n(t).
+ */
+void Bernstein(const int& n, const double& t, float* basis);
+
+/*!
+ * \brief A function evaluating all Bernstein polynomials of a degree at a parameter, with the arguments of Bernstein.
+ */
+using BernsteinFunction = void (*)(const int& n, const double& t, float* basis);
+
+/*!
+ * \brief The largest degree with an evaluator compiled for it.
+ */
+constexpr int BernsteinDegrees = 19;
+
+/*!
+ * \brief Returns the evaluator of the Bernstein polynomials of a degree, looked up once per curve.
+ * Up to BernsteinDegrees the evaluator is compiled for its degree, with the binomial coefficients known
+ * at compile time and the loops unrolled, larger degrees are evaluated by Bernstein.
+ * \param n The degree.
+ * \return The evaluator, which ignores its degree argument unless it is Bernstein.
+ */
+BernsteinFunction BernsteinEvaluator(const int& n);
+
+/*!
+ * \brief A function evaluating all Bernstein polynomials of a degree at a run of consecutive samples of a curve,
+ * into a column-major table with one column of samples per polynomial.
+ * \param n The degree.
+ * \param first The index of the first sample, the parameter of the sample i is i / samples.
+ * \param end The index past the last sample.
+ * \param samples The number of samples of the curve, which is the length of a column.
+ * \param columns The table receiving B_k,n of the sample i at columns[k * samples + i].
+ */
+using BernsteinColumnsFunction = void (*)(const int& n, const int& first, const int& end, const int& samples, float* columns);
+
+/*!
+ * \brief Returns the evaluator of the Bernstein polynomials of a degree over runs of samples, looked up once per curve.
+ * Up to BernsteinDegrees the samples are evaluated several at a time in the vector registers of the running CPU,
+ * with the same operations as the evaluator of BernsteinEvaluator, so both give the same values.
+ * \param n The degree.
+ * \return The evaluator, which ignores its degree argument unless the degree is larger than BernsteinDegrees.
+ */
+BernsteinColumnsFunction BernsteinColumnsEvaluator(const int& n);
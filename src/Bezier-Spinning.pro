@@ -1,12 +1,22 @@
-QT += quick core gui widgets concurrent
+QT += quick core gui gui-private widgets concurrent
 
 SOURCES += \
         Algorithms.cpp \
+        Bernstein.cpp \
         BezierCurve.cpp \
         Circle.cpp \
-        ImageProvider.cpp \
-        PascalTriangle.cpp \
+        Curve.cpp \
+        Executor.cpp \
+        FrameArena.cpp \
+        PointGrid.cpp \
+        RandomStream.cpp \
+        SceneItem.cpp \
         SceneManager.cpp \
+        SegmentTree.cpp \
+        Simd.cpp \
+        SplineCurve.cpp \
+        SpriteAtlas.cpp \
+        TileTexture.cpp \
         main.cpp
 
 resources.files = main.qml 
@@ -26,9 +36,19 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 HEADERS += \
     Algorithms.h \
+    Bernstein.h \
     BezierCurve.h \
     Circle.h \
+    Curve.h \
     Enums.h \
-    ImageProvider.h \
-    PascalTriangle.h \
-    SceneManager.h
+    Executor.h \
+    FrameArena.h \
+    PointGrid.h \
+    RandomStream.h \
+    SceneItem.h \
+    SceneManager.h \
+    SegmentTree.h \
+    Simd.h \
+    SplineCurve.h \
+    SpriteAtlas.h \
+    TileTexture.h
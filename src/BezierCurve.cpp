@@ -1,161 +1,248 @@
-#include <QtConcurrent/QtConcurrent>
-#include <QRandomGenerator>
-#include <QVector2D>
-#include <iterator>
-
 #include "BezierCurve.h"
+#include "Executor.h"
+#include "Simd.h"
 
-BezierCurve::BezierCurve(PascalTriangle triangle, int count) : m_triangle(triangle), m_i(0), m_di(1)
+namespace
 {
-    generate(count);
-}
+using MultiplyAddKernel = void (*)(const float* weights, const float& x, const float& y, float* X, float* Y, const int& count);
+
+// The vector kernels below evaluate exactly the same float expressions as the scalar one
+// (multiply, then add), so all of them produce identical samples.
 
-void BezierCurve::generate(int count)
+void multiplyAddScalar(const float* weights, const float& x, const float& y, float* X, float* Y, const int& count)
 {
-    m_controlPoints.clear();
-    m_points.clear();
-
-    m_cpCount = count;
-    m_selectIdx = -1;
-
-    m_controlPoints = QList<QPoint>(m_cpCount);
-    QtConcurrent::blockingMap(m_controlPoints, [this](const QPoint& p) {
-        std::ptrdiff_t i = std::distance(&m_controlPoints.at(0), &p);
-        int x = QRandomGenerator::global()->bounded(0, m_size.width());
-        int y = QRandomGenerator::global()->bounded(0, m_size.height());
-        m_controlPoints[i] = QPoint(x, y);
-    });
+    for (int i = 0; i < count; i++)
+    {
+        X[i] += x * weights[i];
+        Y[i] += y * weights[i];
+    }
+}
 
-    calculateCurve();
-    if (m_i > m_points.count() - 1)
+#if defined(BEZIER_SIMD_X86)
+BEZIER_TARGET_SSE2 void multiplyAddSSE2(const float* weights, const float& x, const float& y, float* X, float* Y, const int& count)
+{
+    const __m128 vx = _mm_set1_ps(x);
+    const __m128 vy = _mm_set1_ps(y);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
     {
-        m_i = m_points.count() - 1;
+        const __m128 w = _mm_loadu_ps(weights + i);
+        _mm_storeu_ps(X + i, _mm_add_ps(_mm_loadu_ps(X + i), _mm_mul_ps(vx, w)));
+        _mm_storeu_ps(Y + i, _mm_add_ps(_mm_loadu_ps(Y + i), _mm_mul_ps(vy, w)));
     }
-    getCount();
+    multiplyAddScalar(weights + i, x, y, X + i, Y + i, count - i);
 }
 
-void BezierCurve::select(const int& x, const int& y)
+BEZIER_TARGET_AVX2 void multiplyAddAVX2(const float* weights, const float& x, const float& y, float* X, float* Y, const int& count)
 {
-    m_selectIdx = -1;
-    QtConcurrent::blockingMap(m_controlPoints, [this, &x, &y](const QPoint& p) {
-        std::ptrdiff_t i = std::distance(&m_controlPoints.at(0), &p);
-        if (compare(x, y, p.x(), p.y()))
-        {
-            m_selectIdx = i;
-        }
-    });
+    const __m256 vx = _mm256_set1_ps(x);
+    const __m256 vy = _mm256_set1_ps(y);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 w = _mm256_loadu_ps(weights + i);
+        _mm256_storeu_ps(X + i, _mm256_add_ps(_mm256_loadu_ps(X + i), _mm256_mul_ps(vx, w)));
+        _mm256_storeu_ps(Y + i, _mm256_add_ps(_mm256_loadu_ps(Y + i), _mm256_mul_ps(vy, w)));
+    }
+    multiplyAddScalar(weights + i, x, y, X + i, Y + i, count - i);
 }
+#endif
 
-void BezierCurve::drag(const int& x, const int& y)
+MultiplyAddKernel multiplyAddKernel()
 {
-    if (m_selectIdx != -1)
+#if defined(BEZIER_SIMD_X86)
+    switch (simdLevel())
     {
-        m_controlPoints[m_selectIdx] = QPoint(x, y);
-        m_points.clear();
-        calculateCurve();
-        if (m_i > m_points.count() - 1)
+        case SimdLevel::AVX2:
+        {
+            return multiplyAddAVX2;
+        }
+        case SimdLevel::SSE2:
+        {
+            return multiplyAddSSE2;
+        }
+        default:
         {
-            m_i = m_points.count() - 1;
+            break;
         }
     }
+#endif
+    return multiplyAddScalar;
+}
 }
 
-void BezierCurve::paint(QPainter& painter, const bool& drawPolyline) const
+BezierCurve::BezierCurve(int count, quint32 seed) : m_bernstein(&Bernstein), m_basisColumns(BernsteinColumnsEvaluator(-1)),
+      m_derivativeColumns(BernsteinColumnsEvaluator(-1)), m_updates(0)
 {
-    paintCurve(painter);
-    if (drawPolyline)
+    generate(count, seed);
+}
+
+void BezierCurve::finishDrag()
+{
+    if (m_updates > 0)
     {
-        paintPolyline(painter);
+        calculateCurve();
     }
 }
 
-float BezierCurve::currentAngle() const
+void BezierCurve::calculateCurve()
 {
-    const int n = m_cpCount - 2;
-    const QList<int> &row = m_triangle.getRow(n);
-    const auto dB = [&row, &n](const int &i, const float &t) -> float {
-        return row.at(i) * qPow(t, i) * qPow(1 - t, n - i);
-    };
+    const int tCount = getCount();
+    m_updates = 0;
 
-    const float t = static_cast<float>(m_i) / m_points.count();
+    const int n = m_cpCount - 1;
+    m_bernstein = BernsteinEvaluator(n);
+    m_basisColumns = BernsteinColumnsEvaluator(n);
+    m_derivativeColumns = BernsteinColumnsEvaluator(n - 1);
 
-    float X = 0.0f;
-    float Y = 0.0f;
+    m_xs = QList<float>(n + 1);
+    m_ys = QList<float>(n + 1);
     for (int j = 0; j <= n; j++)
     {
-        const float res = dB(j, t);
-        X += (m_controlPoints.at(j + 1).x() - m_controlPoints.at(j).x()) * res;
-        Y += (m_controlPoints.at(j + 1).y() - m_controlPoints.at(j).y()) * res;
+        m_xs[j] = m_controlPoints.at(j).x();
+        m_ys[j] = m_controlPoints.at(j).y();
     }
-    QVector2D T(X, Y);
-    T.normalize();
-    if (T.y() >= 0)
+
+    m_basis = QList<float>(tCount * (n + 1));
+    m_derivativeBasis = QList<float>(tCount * n);
+    m_sampleXs = QList<float>(tCount);
+    m_sampleYs = QList<float>(tCount);
+    m_tangentXs = QList<float>(tCount);
+    m_tangentYs = QList<float>(tCount);
+
+    // a chunk of samples at a time, each sums the columns of its chunk into the sample arrays
+    const MultiplyAddKernel multiplyAdd = multiplyAddKernel();
+    float* basis = m_basis.data();
+    float* derivativeBasis = m_derivativeBasis.data();
+    float* sampleXs = m_sampleXs.data();
+    float* sampleYs = m_sampleYs.data();
+    float* tangentXs = m_tangentXs.data();
+    float* tangentYs = m_tangentYs.data();
+    Executor::instance().forRange(tCount, m_chunk, [&](const int& first, const int& last) {
+        const int count = last - first;
+        // the basis columns of the chunk, several samples at a time
+        m_basisColumns(n, first, last, tCount, basis);
+        m_derivativeColumns(n - 1, first, last, tCount, derivativeBasis);
+
+        for (int j = 0; j <= n; j++)
+        {
+            multiplyAdd(basis + j * tCount + first, m_xs.at(j), m_ys.at(j), sampleXs + first, sampleYs + first, count);
+        }
+        // the direction of the derivative, a Bezier curve of degree n - 1 over the differences of the control points
+        for (int j = 0; j < n; j++)
+        {
+            multiplyAdd(derivativeBasis + j * tCount + first, m_xs.at(j + 1) - m_xs.at(j), m_ys.at(j + 1) - m_ys.at(j),
+                        tangentXs + first, tangentYs + first, count);
+        }
+    });
+
+    m_exact = QList<QPointF>(tCount);
+    m_angles = QList<float>(tCount);
+    updateSamples();
+    calculateLengths();
+    m_tree.build(m_exact);
+    flatten();
+}
+
+void BezierCurve::updateCurve(const QList<int>& indices, const QPoint& delta)
+{
+    if (getCount() != m_exact.count() || m_updates >= m_updateLimit)
     {
-        return qAcos(T.x());
+        // the span of the curve changed the number of samples, or the float samples were updated long enough
+        // for their rounding to add up, and they are calculated again from the control points
+        calculateCurve();
+        return;
     }
-    else
+
+    // the curve is linear in its control points, moving one adds delta * B_idx(t) to every sample,
+    // and delta * (B_idx-1(t) - B_idx(t)) of the degree below to the direction of the derivative
+    const int tCount = m_exact.count();
+    const MultiplyAddKernel multiplyAdd = multiplyAddKernel();
+    m_updates++;
+    for (const int& idx : indices)
     {
-        return 2 * M_PI - qAcos(T.x());
+        m_xs[idx] = m_controlPoints.at(idx).x();
+        m_ys[idx] = m_controlPoints.at(idx).y();
+        multiplyAdd(&m_basis.at(idx * tCount), delta.x(), delta.y(), m_sampleXs.data(), m_sampleYs.data(), tCount);
+        if (idx > 0)
+        {
+            multiplyAdd(&m_derivativeBasis.at((idx - 1) * tCount), delta.x(), delta.y(), m_tangentXs.data(), m_tangentYs.data(), tCount);
+        }
+        if (idx < m_cpCount - 1)
+        {
+            multiplyAdd(&m_derivativeBasis.at(idx * tCount), -delta.x(), -delta.y(), m_tangentXs.data(), m_tangentYs.data(), tCount);
+        }
     }
+    updateSamples();
+    calculateLengths();
+    m_tree.build(m_exact);
+    flatten();
 }
 
-QPoint BezierCurve::first() const
+void BezierCurve::updateSamples()
 {
-    return m_controlPoints.constFirst();
-}
-
-QPoint BezierCurve::last() const
-{
-    return m_controlPoints.constLast();
+    for (int i = 0; i < m_exact.count(); i++)
+    {
+        m_exact[i] = QPointF(m_sampleXs.at(i), m_sampleYs.at(i));
+        m_angles[i] = angleOf(QPointF(m_tangentXs.at(i), m_tangentYs.at(i)));
+    }
 }
 
-QPoint BezierCurve::current() const
+void BezierCurve::flatten()
 {
-    return m_points.at(m_i);
+    m_polyline.clear();
+    m_polyline.append(m_controlPoints.constFirst());
+    if (m_cpCount <= m_casteljauLimit)
+    {
+        QVarLengthArray<QPointF, 32> points;
+        for (const QPoint& p : m_controlPoints)
+        {
+            points.append(p);
+        }
+        subdivide(points, 0, m_polyline);
+    }
+    else
+    {
+        // splitting the control polygon costs the square of the degree and it converges slowly,
+        // so long curves are split by evaluating them instead
+        subdivide(0.0, m_controlPoints.constFirst(), 1.0, m_controlPoints.constLast(), 0);
+    }
 }
 
-QPoint BezierCurve::next()
+void BezierCurve::subdivide(const double& t0, const QPointF& a, const double& t1, const QPointF& b, const int& depth)
 {
-    if ((m_i == 0 && m_di < 0) || (m_i == m_points.count() - 1 && m_di > 0))
+    const double t = (t0 + t1) / 2;
+    const QPointF m = evaluate(t);
+    // the first splits are forced, so no loop of the curve hides between the ends of a part
+    if (depth >= m_minDepth)
     {
-        m_di = -m_di;
+        const QPointF chord = b - a;
+        const qreal squared = QPointF::dotProduct(chord, chord);
+        const QPointF d = m - a;
+        const qreal s = squared > 0.0 ? qBound(0.0, QPointF::dotProduct(d, chord) / squared, 1.0) : 0.0;
+        const QPointF e = d - s * chord;
+        if (QPointF::dotProduct(e, e) <= m_tolerance * m_tolerance || depth >= m_maxDepth)
+        {
+            m_polyline.append(b);
+            return;
+        }
     }
-    m_i += m_di;
-    return current();
+    subdivide(t0, a, t, m, depth + 1);
+    subdivide(t, m, t1, b, depth + 1);
 }
 
-void BezierCurve::calculateCurve()
+QPointF BezierCurve::evaluate(const double& t) const
 {
-    const int tCount = getCount();
-    const float step = 1.0f / tCount;
-
-    const int n = m_cpCount - 1;
-    const QList<int> &row = m_triangle.getRow(n);
-    const auto B = [&row, &n](const int &i, const float &t) -> float {
-        return row.at(i) * qPow(t, i) * qPow(1 - t, n - i);
-    };
-
-    QList<float> ts(tCount);
-    ts[0] = 0.0f;
-    for (int i = 1; i < tCount; i++)
+    QVarLengthArray<float, 256> basis(m_cpCount);
+    m_bernstein(m_cpCount - 1, t, basis.data());
+    double X = 0.0;
+    double Y = 0.0;
+    for (int j = 0; j < m_cpCount; j++)
     {
-        ts[i] = ts[i - 1] + step;
+        X += m_xs.at(j) * basis[j];
+        Y += m_ys.at(j) * basis[j];
     }
-
-    m_points = QList<QPoint>(tCount);
-    QtConcurrent::blockingMap(m_points, [this, &ts, &n, &B](const QPoint& p) {
-        std::ptrdiff_t i = std::distance(&m_points.at(0), &p);
-        const float& t = ts.at(i);
-        float X = 0.0f;
-        float Y = 0.0f;
-        for (int j = 0; j <= n; j++)
-        {
-            const float res = B(j, t);
-            X += m_controlPoints.at(j).x() * res;
-            Y += m_controlPoints.at(j).y() * res;
-        }
-        m_points[i] = QPoint(X, Y);
-    });
+    return QPointF(X, Y);
 }
 
 int BezierCurve::getCount() const
@@ -186,55 +273,6 @@ int BezierCurve::getCount() const
         }
     }
 
-    return qMax(maxX - minX, maxY - minY) / 2;
-}
-
-void BezierCurve::paintCurve(QPainter& painter) const
-{
-    QPen pen;
-    pen.setCapStyle(Qt::RoundCap);
-    pen.setWidth(m_lineWidth + 2);
-    pen.setColor(m_lineColor);
-    painter.setPen(pen);
-
-    for (int i = 0; i < m_points.count() - 1; i++)
-    {
-        painter.drawLine(m_points.at(i), m_points.at(i + 1));
-    }
-}
-
-void BezierCurve::paintPolyline(QPainter& painter) const
-{
-    QPen pen;
-    pen.setCapStyle(Qt::RoundCap);
-    for (int i = 0; i < m_controlPoints.count() - 1; i++)
-    {
-        pen.setWidth(m_lineWidth);
-        pen.setColor(m_lineColor);
-        painter.setPen(pen);
-        painter.drawLine(m_controlPoints.at(i), m_controlPoints.at(i + 1));
-
-        pen.setWidth(m_pointWidth);
-        if (i == m_selectIdx)
-        {
-            pen.setColor(m_selectColor);
-        }
-        else
-        {
-            pen.setColor(m_pointColor);
-        }
-        painter.setPen(pen);
-        painter.drawPoint(m_controlPoints.at(i));
-    }
-
-    if (m_controlPoints.count() - 1 == m_selectIdx)
-    {
-        pen.setColor(m_selectColor);
-    }
-    else
-    {
-        pen.setColor(m_pointColor);
-    }
-    painter.setPen(pen);
-    painter.drawPoint(m_controlPoints.constLast());
+    // two samples at least, so that points all in one place still give a curve with a first and a last sample
+    return qMax(2, qMax(maxX - minX, maxY - minY) / 2);
 }
@@ -1,163 +1,132 @@
 #pragma once
 
-#include <QPainter>
-#include <QColor>
-#include <QPoint>
-#include <QSize>
-#include <QtMath>
-
-#include "PascalTriangle.h"
+#include "Bernstein.h"
+#include "Curve.h"
 
 /*!
  * \brief The BezierCurve class
  * This class represents a Bezier curve.
- * It provides methods to generate the curve, select and drag control points, and paint the curve.
+ * Every control point moves the whole curve, so it suits a few hundred control points at most.
  */
-class BezierCurve
+class BezierCurve : public Curve
 {
   public:
     /*!
      * \brief Constructs a BezierCurve object
-     * \param triangle The Pascal's triangle used for the curve calculation
-     * \param count The number of control points for the curve
-     */
-    explicit BezierCurve(PascalTriangle triangle, int count = 3);
-    /*!
-     * \brief Generates the Bezier curve
      * \param count The number of control points for the curve
+     * \param seed The seed of the control points
      */
-    void generate(int count);
+    explicit BezierCurve(int count = 3, quint32 seed = 0);
     /*!
-     * \brief Selects a control point
-     * \param x The x-coordinate of the point to select
-     * \param y The y-coordinate of the point to select
+     * \brief Ends a drag, calculating the curve again if it was updated incrementally, so the rounding
+     * of the accumulated float samples never outlives the drag
      */
-    void select(const int& x, const int& y);
+    void finishDrag() override;
+
+  private:
     /*!
-     * \brief Drags a control point
-     * \param x The x-coordinate of the point to drag
-     * \param y The y-coordinate of the point to drag
+     * \brief The minimal depth of the subdivision of curves flattened by evaluation
      */
-    void drag(const int& x, const int& y);
+    const int m_minDepth = 4;
     /*!
-     * \brief Paints the Bezier curve
-     * \param painter The QPainter object used for painting
-     * \param drawPolyline A boolean indicating whether to draw the polyline
+     * \brief The largest number of control points for which the control polygon is subdivided
      */
-    void paint(QPainter& painter, const bool& drawPolyline) const;
+    const int m_casteljauLimit = 32;
     /*!
-     * \brief Returns the angle between x-axis and tangent vector at the current point of Bezier curve
-     * \return A float representing the current angle of the Bezier curve
+     * \brief The evaluator of the Bernstein basis of the degree of the curve
      */
-    float currentAngle() const;
+    BernsteinFunction m_bernstein;
     /*!
-     * \brief Returns the first control point of the Bezier curve
-     * \return A QPoint representing the first control point of the Bezier curve
+     * \brief The evaluator of the Bernstein basis of the degree of the curve over runs of samples
      */
-    QPoint first() const;
+    BernsteinColumnsFunction m_basisColumns;
     /*!
-     * \brief Returns the last control point of the Bezier curve
-     * \return A QPoint representing the last control point of the Bezier curve
+     * \brief The evaluator of the Bernstein basis of the degree below over runs of samples, for the derivative
      */
-    QPoint last() const;
+    BernsteinColumnsFunction m_derivativeColumns;
     /*!
-     * \brief Returns the current point on the Bezier curve
-     * \return A QPoint representing the current point on the Bezier curve
+     * \brief The number of samples evaluated by one chunk of the parallel loop
      */
-    QPoint current() const;
+    const int m_chunk = 256;
     /*!
-     * \brief Moves to the next point on the Bezier curve and returns it
-     * \return A QPoint representing the next point on the Bezier curve
+     * \brief The number of incremental updates after which a drag calculates the curve in full,
+     * before the rounding of the accumulated samples adds up
      */
-    QPoint next();
-
-  private:
+    const int m_updateLimit = 64;
     /*!
-     * \brief The size of the scene
+     * \brief The number of incremental updates since the curve was last calculated in full
      */
-    const QSize m_size = QSize(800, 800);
+    int m_updates;
     /*!
-     * \brief The color of the curve line
+     * \brief The x-coordinates of the control points
      */
-    const QColor m_lineColor = QColor(0, 0, 0);
+    QList<float> m_xs;
     /*!
-     * \brief The color of the control points
+     * \brief The y-coordinates of the control points
      */
-    const QColor m_pointColor = QColor(0, 0, 255);
+    QList<float> m_ys;
     /*!
-     * \brief The color of the selected control point
+     * \brief The Bernstein basis of every sample, column-major with one column of samples per control point
      */
-    const QColor m_selectColor = QColor(255, 0, 0);
+    QList<float> m_basis;
     /*!
-     * \brief The margin for the control point selection
+     * \brief The Bernstein basis of the degree below for every sample, column-major with m_cpCount - 1 columns
      */
-    const int m_margin = 10;
+    QList<float> m_derivativeBasis;
     /*!
-     * \brief The width of the curve line
+     * \brief The x-coordinates of the samples
      */
-    const int m_lineWidth = 1;
+    QList<float> m_sampleXs;
     /*!
-     * \brief The width of the control points
+     * \brief The y-coordinates of the samples
      */
-    const int m_pointWidth = 7;
+    QList<float> m_sampleYs;
     /*!
-     * \brief The Pascal's triangle used for the curve calculation
+     * \brief The x-coordinates of the direction of the tangent vector at every sample, not normalized
      */
-    PascalTriangle m_triangle;
+    QList<float> m_tangentXs;
     /*!
-     * \brief The control points of the Bezier curve
+     * \brief The y-coordinates of the direction of the tangent vector at every sample, not normalized
      */
-    QList<QPoint> m_controlPoints;
+    QList<float> m_tangentYs;
     /*!
-     * \brief The points on the Bezier curve
+     * \brief Calculates the Bezier curve
      */
-    QList<QPoint> m_points;
+    void calculateCurve() override;
     /*!
-     * \brief The number of control points for the curve
+     * \brief Updates the points on the Bezier curve after some control points moved
+     * \param indices The indices of the moved control points in ascending order
+     * \param delta The displacement of the control points
      */
-    int m_cpCount;
+    void updateCurve(const QList<int>& indices, const QPoint& delta) override;
     /*!
-     * \brief The index of the selected control point
+     * \brief Copies the samples into the points and the angles shared with the other curves
      */
-    int m_selectIdx;
+    void updateSamples();
     /*!
-     * \brief The current index on the Bezier curve
+     * \brief Flattens the curve into the painted polyline
      */
-    int m_i;
+    void flatten() override;
+    using Curve::subdivide;
     /*!
-     * \brief The direction of the current index on the Bezier curve (either 1 or -1)
+     * \brief Appends the end of a part of the curve to the polyline once its middle is within the tolerance
+     * from the chord, splits it in half otherwise
+     * \param t0 The parameter of the start of the part
+     * \param a The start of the part
+     * \param t1 The parameter of the end of the part
+     * \param b The end of the part
+     * \param depth The depth of the subdivision
      */
-    int m_di;
+    void subdivide(const double& t0, const QPointF& a, const double& t1, const QPointF& b, const int& depth);
     /*!
-     * \brief Calculates the Bezier curve
+     * \brief Evaluates the Bezier curve
+     * \param t The parameter in [0, 1]
+     * \return The point of the curve
      */
-    void calculateCurve();
+    QPointF evaluate(const double& t) const;
     /*!
      * \brief Returns the number of points to be generated based on the span of the curve
-     * \return An integer representing the number of points
+     * \return An integer representing the number of points, at least 2
      */
     int getCount() const;
-    /*!
-     * \brief Paints the curve of the Bezier curve
-     * \param painter The QPainter object used for painting
-     */
-    void paintCurve(QPainter &painter) const;
-    /*!
-     * \brief Paints the polyline of the Bezier curve
-     * \param painter The QPainter object used for painting
-     */
-    void paintPolyline(QPainter &painter) const;
-    /*!
-     * \brief Compares two points
-     * \param x1 The x-coordinate of the first point
-     * \param y1 The y-coordinate of the first point
-     * \param x2 The x-coordinate of the second point
-     * \param y2 The y-coordinate of the second point
-     * \return A boolean indicating whether the two points are close enough (within margin)
-     */
-    inline bool compare(const int& x1, const int& y1, const int& x2, const int& y2)
-    {
-        if (qFabs(x1 - x2) <= m_margin && qFabs(y1 - y2) <= m_margin) { return true; }
-        return false;
-    }
 };
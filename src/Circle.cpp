@@ -24,3 +24,8 @@ float Circle::next()
     m_i = (m_i + 1) % m_count;
     return current();
 }
+
+const QList<float>& Circle::degrees() const
+{
+    return m_degrees;
+}
@@ -25,6 +25,11 @@ class Circle
      * \return A float representing the next degree on the circle
      */
     float next();
+    /*!
+     * \brief Returns all degrees on the circle
+     * \return A list of the degrees in the order they are visited
+     */
+    const QList<float>& degrees() const;
 
   private:
     /*!
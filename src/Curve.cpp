@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <iterator>
+
+#include "Curve.h"
+#include "Executor.h"
+#include "RandomStream.h"
+
+Curve::Curve() : m_tolerance(0.25f), m_cpCount(0), m_selectIdx(-1), m_s(0.0), m_di(1) {}
+
+void Curve::generate(const int& count, const quint32& seed)
+{
+    m_cpCount = count;
+    m_selectIdx = -1;
+    m_selection.clear();
+
+    m_controlPoints = randomPoints(m_cpCount, m_size, seed);
+
+    m_grid.build(m_controlPoints);
+    calculateCurve();
+}
+
+QList<QPoint> Curve::randomPoints(const int& count, const QSize& size, const quint32& seed)
+{
+    QList<QPoint> points(count);
+    // every point opens the stream at its own position, so the chunks the threads get do not matter
+    Executor::instance().forRange(count, 1024, [&points, &size, &seed](const int& begin, const int& end) {
+        for (int i = begin; i < end; i++)
+        {
+            RandomStream stream(seed, 2 * quint64(i));
+            const int x = stream.bounded(0, size.width());
+            const int y = stream.bounded(0, size.height());
+            points[i] = QPoint(x, y);
+        }
+    });
+    return points;
+}
+
+void Curve::setControlPoints(const QList<QPoint>& points)
+{
+    m_controlPoints = points;
+    m_cpCount = points.count();
+    m_selectIdx = -1;
+    m_selection.clear();
+
+    m_grid.build(m_controlPoints);
+    calculateCurve();
+}
+
+const QList<QPoint>& Curve::controlPoints() const
+{
+    return m_controlPoints;
+}
+
+float Curve::tolerance() const
+{
+    return m_tolerance;
+}
+
+void Curve::setTolerance(const float& tolerance)
+{
+    m_tolerance = tolerance;
+    flatten();
+}
+
+int Curve::segmentCount() const
+{
+    return m_polyline.count() - 1;
+}
+
+void Curve::select(const int& x, const int& y)
+{
+    m_selectIdx = m_grid.nearest(m_controlPoints, QPoint(x, y), m_margin);
+    if (m_selectIdx == -1)
+    {
+        m_selection.clear();
+    }
+    else if (!std::binary_search(m_selection.cbegin(), m_selection.cend(), m_selectIdx))
+    {
+        m_selection = { m_selectIdx };
+    }
+}
+
+void Curve::selectRect(const QRect& rect)
+{
+    m_selectIdx = -1;
+    m_selection = m_grid.inside(m_controlPoints, rect.normalized());
+}
+
+const QList<int>& Curve::selection() const
+{
+    return m_selection;
+}
+
+void Curve::drag(const int& x, const int& y)
+{
+    if (m_selectIdx != -1)
+    {
+        const QPoint delta = QPoint(x, y) - m_controlPoints.at(m_selectIdx);
+        if (delta.isNull()) { return; }
+        for (const int& i : m_selection)
+        {
+            const QPoint p = m_controlPoints.at(i);
+            m_controlPoints[i] = p + delta;
+            m_grid.move(i, p, p + delta);
+        }
+        updateCurve(m_selection, delta);
+    }
+}
+
+void Curve::finishDrag() {}
+
+void Curve::paint(QPainter& painter, const bool& drawPolyline) const
+{
+    paintCurve(painter);
+    if (drawPolyline)
+    {
+        paintPolyline(painter);
+    }
+}
+
+float Curve::currentAngle() const
+{
+    const double sample = sampleAt(m_s);
+    const int i = qMin<int>(sample, m_angles.count() - 1);
+    if (i == m_angles.count() - 1) { return m_angles.at(i); }
+    // the angles wrap around at a full turn, so the shorter way between the samples is taken
+    float delta = m_angles.at(i + 1) - m_angles.at(i);
+    if (delta > M_PI)
+    {
+        delta -= 2 * M_PI;
+    }
+    else if (delta < -M_PI)
+    {
+        delta += 2 * M_PI;
+    }
+    const float angle = m_angles.at(i) + (sample - i) * delta;
+    return angle < 0.0f ? angle + 2 * M_PI : (angle >= 2 * M_PI ? angle - 2 * M_PI : angle);
+}
+
+QPoint Curve::first() const
+{
+    return m_controlPoints.constFirst();
+}
+
+QPoint Curve::last() const
+{
+    return m_controlPoints.constLast();
+}
+
+QPointF Curve::current() const
+{
+    if (m_exact.isEmpty()) { return QPointF(); }
+    const double sample = sampleAt(m_s);
+    const int i = qMin<int>(sample, m_exact.count() - 1);
+    // between two samples the curve is close enough to the chord joining them
+    const double f = sample - i;
+    return i == m_exact.count() - 1 ? m_exact.at(i) : m_exact.at(i) * (1 - f) + m_exact.at(i + 1) * f;
+}
+
+CurveProjection Curve::projectToCurve(const int& x, const int& y) const
+{
+    const QPointF p(x, y);
+    double fraction = 0.0;
+    const int i = m_tree.nearest(m_exact, p, fraction);
+    if (i == -1)
+    {
+        const QPointF point = m_exact.isEmpty() ? QPointF() : m_exact.constFirst();
+        const QPointF d = point - p;
+        return { m_exact.isEmpty() ? -1 : 0, 0.0, 0.0, point, qSqrt(QPointF::dotProduct(d, d)) };
+    }
+    const QPointF point = m_exact.at(i) * (1 - fraction) + m_exact.at(i + 1) * fraction;
+    const QPointF d = point - p;
+    const double s = m_lengths.at(i) + fraction * (m_lengths.at(i + 1) - m_lengths.at(i));
+    return { i, fraction, s, point, qSqrt(QPointF::dotProduct(d, d)) };
+}
+
+void Curve::setDistance(const double& s)
+{
+    if (m_lengths.isEmpty()) { return; }
+    m_s = qBound(0.0, s, m_lengths.constLast());
+}
+
+QPointF Curve::next()
+{
+    if (m_lengths.isEmpty()) { return QPointF(); }
+    const double length = m_lengths.constLast();
+    if ((m_s <= 0.0 && m_di < 0) || (m_s >= length && m_di > 0))
+    {
+        m_di = -m_di;
+    }
+    m_s = qBound(0.0, m_s + m_di * m_speed, length);
+    return current();
+}
+
+void Curve::calculateLengths()
+{
+    m_lengths = QList<double>(m_exact.count());
+    double length = 0.0;
+    for (int i = 1; i < m_exact.count(); i++)
+    {
+        const QPointF d = m_exact.at(i) - m_exact.at(i - 1);
+        length += qSqrt(d.x() * d.x() + d.y() * d.y());
+        m_lengths[i] = length;
+    }
+    // the sprite keeps its distance from the first point, unless the curve got shorter than that
+    m_s = qMin(m_s, length);
+}
+
+double Curve::sampleAt(const double& s) const
+{
+    if (m_lengths.count() < 2) { return 0.0; }
+    const auto it = std::upper_bound(m_lengths.cbegin(), m_lengths.cend(), s);
+    const int i = qBound<int>(0, std::distance(m_lengths.cbegin(), it) - 1, m_lengths.count() - 2);
+    const double span = m_lengths.at(i + 1) - m_lengths.at(i);
+    const double f = span > 0.0 ? qBound(0.0, (s - m_lengths.at(i)) / span, 1.0) : 0.0;
+    return i + f;
+}
+
+float Curve::angleOf(const QPointF& tangent)
+{
+    const float angle = qAtan2(tangent.y(), tangent.x());
+    return angle < 0.0f ? angle + 2 * M_PI : angle;
+}
+
+void Curve::subdivide(const QVarLengthArray<QPointF, 32>& points, const int& depth, QList<QPointF>& polyline) const
+{
+    // the curve stays inside the hull of its control points, so it is flat enough
+    // once all of them are within the tolerance from the chord
+    const QPointF& a = points.constFirst();
+    const QPointF chord = points.constLast() - a;
+    const qreal squared = QPointF::dotProduct(chord, chord);
+    qreal flatness = 0.0;
+    for (int i = 1; i < points.count() - 1; i++)
+    {
+        const QPointF d = points.at(i) - a;
+        const qreal t = squared > 0.0 ? qBound(0.0, QPointF::dotProduct(d, chord) / squared, 1.0) : 0.0;
+        const QPointF e = d - t * chord;
+        flatness = qMax(flatness, QPointF::dotProduct(e, e));
+    }
+    if (flatness <= m_tolerance * m_tolerance || depth >= m_maxDepth)
+    {
+        polyline.append(points.constLast());
+        return;
+    }
+
+    const int n = points.count();
+    QVarLengthArray<QPointF, 32> work = points;
+    QVarLengthArray<QPointF, 32> left(n);
+    QVarLengthArray<QPointF, 32> right(n);
+    for (int k = 0; k < n; k++)
+    {
+        left[k] = work.at(0);
+        right[n - 1 - k] = work.at(n - 1 - k);
+        for (int i = 0; i < n - 1 - k; i++)
+        {
+            work[i] = (work.at(i) + work.at(i + 1)) / 2;
+        }
+    }
+    subdivide(left, depth + 1, polyline);
+    subdivide(right, depth + 1, polyline);
+}
+
+void Curve::paintCurve(QPainter& painter) const
+{
+    QPen pen;
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+    pen.setWidth(m_lineWidth + 2);
+    pen.setColor(m_lineColor);
+    painter.setPen(pen);
+
+    painter.drawPolyline(m_polyline.constData(), m_polyline.count());
+}
+
+void Curve::paintPolyline(QPainter& painter) const
+{
+    // one call per kind of primitive, a pen change per control point is too slow for long polygons
+    QPen pen;
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setWidth(m_lineWidth);
+    pen.setColor(m_lineColor);
+    painter.setPen(pen);
+    painter.drawPolyline(m_controlPoints.constData(), m_controlPoints.count());
+
+    pen.setWidth(m_pointWidth);
+    pen.setColor(m_pointColor);
+    painter.setPen(pen);
+    painter.drawPoints(m_controlPoints.constData(), m_controlPoints.count());
+
+    pen.setColor(m_selectColor);
+    painter.setPen(pen);
+    for (const int& i : m_selection)
+    {
+        painter.drawPoint(m_controlPoints.at(i));
+    }
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <QPainter>
+#include <QColor>
+#include <QList>
+#include <QPoint>
+#include <QPointF>
+#include <QSize>
+#include <QVarLengthArray>
+#include <QtMath>
+
+#include "PointGrid.h"
+#include "SegmentTree.h"
+
+/*!
+ * \brief The point of a curve closest to a position
+ */
+struct CurveProjection
+{
+    /*!
+     * \brief The index of the sample before the point, or -1 if the curve has no samples
+     */
+    int index;
+    /*!
+     * \brief The fraction of the way from the sample to the next one
+     */
+    double fraction;
+    /*!
+     * \brief The distance from the first point, measured along the curve
+     */
+    double s;
+    /*!
+     * \brief The point of the curve
+     */
+    QPointF point;
+    /*!
+     * \brief The distance between the point and the position
+     */
+    double distance;
+};
+
+/*!
+ * \brief The Curve class
+ * This class is the base of the curves the sprite moves along.
+ * It holds the control points and the samples of the curve, and provides methods to select and drag control points,
+ * paint the curve and move along it. The derived classes evaluate and flatten the curve.
+ */
+class Curve
+{
+  public:
+    /*!
+     * \brief Constructs a Curve object without control points, the derived classes generate them
+     */
+    Curve();
+    virtual ~Curve() = default;
+    /*!
+     * \brief Generates the curve from random control points
+     * \param count The number of control points for the curve
+     * \param seed The seed of the control points, the same seed always gives the same curve
+     */
+    void generate(const int& count, const quint32& seed);
+    /*!
+     * \brief Draws random control points in parallel, the point i from the positions 2i and 2i + 1 of the stream of the seed
+     * \param count The number of points
+     * \param size The size of the area the points lie in
+     * \param seed The seed of the points
+     * \return The points, the same for the same seed on any number of threads
+     */
+    static QList<QPoint> randomPoints(const int& count, const QSize& size, const quint32& seed);
+    /*!
+     * \brief Replaces the control points of the curve
+     * \param points The new control points
+     */
+    void setControlPoints(const QList<QPoint>& points);
+    /*!
+     * \brief Returns the control points of the curve
+     * \return The list of the control points
+     */
+    const QList<QPoint>& controlPoints() const;
+    /*!
+     * \brief Returns the maximal distance between the painted polyline and the curve
+     * \return The tolerance in pixels
+     */
+    float tolerance() const;
+    /*!
+     * \brief Sets the maximal distance between the painted polyline and the curve, and flattens the curve again
+     * \param tolerance The tolerance in pixels
+     */
+    void setTolerance(const float& tolerance);
+    /*!
+     * \brief Returns the number of segments of the painted polyline
+     * \return An integer representing the number of segments
+     */
+    int segmentCount() const;
+    /*!
+     * \brief Grabs the control point closest to a position, pressing on one of several selected points keeps them all
+     * \param x The x-coordinate of the point to select
+     * \param y The y-coordinate of the point to select
+     */
+    void select(const int& x, const int& y);
+    /*!
+     * \brief Selects all control points inside a rectangle, which are then dragged together
+     * \param rect The rectangle
+     */
+    void selectRect(const QRect& rect);
+    /*!
+     * \brief Returns the selected control points
+     * \return The indices of the selected points in ascending order
+     */
+    const QList<int>& selection() const;
+    /*!
+     * \brief Drags the selected control points, so the grabbed one reaches a position
+     * \param x The x-coordinate of the point to drag
+     * \param y The y-coordinate of the point to drag
+     */
+    void drag(const int& x, const int& y);
+    /*!
+     * \brief Ends a drag, the curves updated approximately while dragging are calculated again from their control points
+     */
+    virtual void finishDrag();
+    /*!
+     * \brief Paints the curve
+     * \param painter The QPainter object used for painting
+     * \param drawPolyline A boolean indicating whether to draw the polyline
+     */
+    void paint(QPainter& painter, const bool& drawPolyline) const;
+    /*!
+     * \brief Returns the angle between x-axis and tangent vector at the current point of the curve,
+     * interpolated from the angles stored for the samples
+     * \return A float representing the current angle of the curve
+     */
+    float currentAngle() const;
+    /*!
+     * \brief Returns the first control point of the curve
+     * \return A QPoint representing the first control point of the curve
+     */
+    QPoint first() const;
+    /*!
+     * \brief Returns the last control point of the curve
+     * \return A QPoint representing the last control point of the curve
+     */
+    QPoint last() const;
+    /*!
+     * \brief Returns the current point on the curve
+     * \return A QPointF representing the current point on the curve, between pixels
+     */
+    QPointF current() const;
+    /*!
+     * \brief Finds the point of the curve closest to a position
+     * \param x The x-coordinate of the position
+     * \param y The y-coordinate of the position
+     * \return The point with its sample, its distance along the curve and its distance from the position
+     */
+    CurveProjection projectToCurve(const int& x, const int& y) const;
+    /*!
+     * \brief Moves the current point to a distance along the curve
+     * \param s The distance from the first point, clamped to the length of the curve
+     */
+    void setDistance(const double& s);
+    /*!
+     * \brief Moves a constant distance along the curve and returns the point reached
+     * \return A QPointF representing the next point on the curve, between pixels
+     */
+    QPointF next();
+
+  protected:
+    /*!
+     * \brief The size of the scene
+     */
+    const QSize m_size = QSize(800, 800);
+    /*!
+     * \brief The color of the curve line
+     */
+    const QColor m_lineColor = QColor(0, 0, 0);
+    /*!
+     * \brief The color of the control points
+     */
+    const QColor m_pointColor = QColor(0, 0, 255);
+    /*!
+     * \brief The color of the selected control point
+     */
+    const QColor m_selectColor = QColor(255, 0, 0);
+    /*!
+     * \brief The margin for the control point selection
+     */
+    const int m_margin = 10;
+    /*!
+     * \brief The width of the curve line
+     */
+    const int m_lineWidth = 1;
+    /*!
+     * \brief The width of the control points
+     */
+    const int m_pointWidth = 7;
+    /*!
+     * \brief The distance travelled along the curve in every step of the animation
+     */
+    const float m_speed = 3.0f;
+    /*!
+     * \brief The maximal depth of the subdivision, which bounds the polyline to 2^16 segments
+     */
+    const int m_maxDepth = 16;
+    /*!
+     * \brief The control points of the curve
+     */
+    QList<QPoint> m_controlPoints;
+    /*!
+     * \brief The points on the curve
+     */
+    QList<QPointF> m_exact;
+    /*!
+     * \brief The angle between x-axis and the tangent vector at every sample
+     */
+    QList<float> m_angles;
+    /*!
+     * \brief The flattened curve, the polyline which is painted
+     */
+    QList<QPointF> m_polyline;
+    /*!
+     * \brief The maximal distance between the painted polyline and the curve
+     */
+    float m_tolerance;
+    /*!
+     * \brief The number of control points for the curve
+     */
+    int m_cpCount;
+    /*!
+     * \brief The index of the grabbed control point, which follows the mouse
+     */
+    int m_selectIdx;
+    /*!
+     * \brief The indices of the selected control points in ascending order
+     */
+    QList<int> m_selection;
+    /*!
+     * \brief The spatial index of the control points
+     */
+    PointGrid m_grid;
+    /*!
+     * \brief The hierarchy of the bounding boxes of the segments between the samples
+     */
+    SegmentTree m_tree;
+    /*!
+     * \brief The arc length of the curve from its first point up to every sample,
+     * in double precision so the long splines keep a sub-pixel resolution
+     */
+    QList<double> m_lengths;
+    /*!
+     * \brief The current distance from the first point, measured along the curve
+     */
+    double m_s;
+    /*!
+     * \brief The direction of the movement along the curve (either 1 or -1)
+     */
+    int m_di;
+    /*!
+     * \brief Calculates the samples of the curve from all of its control points
+     */
+    virtual void calculateCurve() = 0;
+    /*!
+     * \brief Updates the samples of the curve after some control points moved
+     * \param indices The indices of the moved control points in ascending order
+     * \param delta The displacement of the control points
+     */
+    virtual void updateCurve(const QList<int>& indices, const QPoint& delta) = 0;
+    /*!
+     * \brief Flattens the curve into the painted polyline
+     */
+    virtual void flatten() = 0;
+    /*!
+     * \brief Fills the arc length table from the points on the curve
+     */
+    void calculateLengths();
+    /*!
+     * \brief Finds the sample at a distance along the curve with a binary search in the arc length table
+     * \param s The distance from the first point
+     * \return The index of the sample before the distance plus the fraction of the way to the next one
+     */
+    double sampleAt(const double& s) const;
+    /*!
+     * \brief Returns the angle between x-axis and a tangent vector
+     * \param tangent The tangent vector
+     * \return The angle in [0, 2 * pi)
+     */
+    static float angleOf(const QPointF& tangent);
+    /*!
+     * \brief Appends the end of a Bezier part of the curve to a polyline once the part is flat enough,
+     * splits it in half with the de Casteljau algorithm otherwise
+     * \param points The control points of the part of the curve
+     * \param depth The depth of the subdivision
+     * \param polyline The polyline the ends of the flat parts are appended to
+     */
+    void subdivide(const QVarLengthArray<QPointF, 32>& points, const int& depth, QList<QPointF>& polyline) const;
+    /*!
+     * \brief Paints the flattened curve
+     * \param painter The QPainter object used for painting
+     */
+    void paintCurve(QPainter &painter) const;
+    /*!
+     * \brief Paints the polyline of the control points
+     * \param painter The QPainter object used for painting
+     */
+    void paintPolyline(QPainter &painter) const;
+};
@@ -5,7 +5,7 @@
 /*!
  * \brief The Algorithm class
  * This class represents an algorithm type for image transformations.
- * It includes two algorithms: Naive and Shear.
+ * It includes four algorithms: Naive, Bilinear, Bicubic and Shear.
  */
 class Algorithm : public QObject
 {
@@ -15,7 +15,7 @@ class Algorithm : public QObject
      * \enum Enum
      * \brief The enumeration of algorithms.
      */
-    enum class Enum { Naive, Shear };
+    enum class Enum { Naive, Shear, Bilinear, Bicubic };
     Q_ENUM(Enum)
 };
 
@@ -35,3 +35,20 @@ class Animation : public QObject
     enum class Enum { Rotation, Moving };
     Q_ENUM(Enum)
 };
+
+/*!
+ * \brief The CurveType class
+ * This class represents a type of the curve the sprite moves along.
+ * It includes two curves: Bezier and Spline.
+ */
+class CurveType : public QObject
+{
+    Q_OBJECT
+  public:
+    /*!
+     * \enum Enum
+     * \brief The enumeration of curves.
+     */
+    enum class Enum { Bezier, Spline };
+    Q_ENUM(Enum)
+};
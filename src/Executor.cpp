@@ -0,0 +1,191 @@
+#include <QThread>
+#include <limits>
+
+#include "Executor.h"
+
+Executor& Executor::instance()
+{
+    static Executor executor(QThread::idealThreadCount());
+    return executor;
+}
+
+Executor::Executor(const int& threads)
+    : m_threadCount(0), m_isBusy(false), m_tileBytes(64 * 1024), m_generation(0), m_pending(0), m_isStopping(false),
+      m_body(nullptr), m_context(nullptr), m_count(0), m_grain(1)
+{
+    start(threads);
+}
+
+Executor::~Executor()
+{
+    stop();
+}
+
+int Executor::threadCount() const
+{
+    return m_threadCount;
+}
+
+void Executor::setThreadCount(const int& count)
+{
+    // waits for the running loop, then keeps others on their calling threads until the pool is back
+    while (m_isBusy.exchange(true))
+    {
+        std::this_thread::yield();
+    }
+    stop();
+    start(count);
+    m_isBusy = false;
+}
+
+qsizetype Executor::tileBytes() const
+{
+    return m_tileBytes;
+}
+
+void Executor::setTileBytes(const qsizetype& bytes)
+{
+    m_tileBytes = qMax<qsizetype>(1, bytes);
+}
+
+int Executor::rowGrain(const qsizetype& rowBytes) const
+{
+    return static_cast<int>(qBound<qsizetype>(1, m_tileBytes / qMax<qsizetype>(1, rowBytes), std::numeric_limits<int>::max()));
+}
+
+void Executor::run(const int& count, const int& grain, const Body& body, const void* context)
+{
+    if (count <= 0) { return; }
+    const int chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || m_isBusy.exchange(true))
+    {
+        body(context, 0, count);
+        return;
+    }
+    // the threads are only looked at once the pool is claimed, setThreadCount rebuilds them while holding it
+    if (m_threads.empty())
+    {
+        m_isBusy = false;
+        body(context, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = body;
+        m_context = context;
+        m_count = count;
+        m_grain = grain;
+        // every participant starts on a contiguous share, so neighbouring chunks stay on one core
+        const int participants = threadCount();
+        for (int id = 0; id < participants; id++)
+        {
+            std::lock_guard<std::mutex> shareLock(m_shares[id].mutex);
+            m_shares[id].begin = static_cast<int>(qint64(chunks) * id / participants);
+            m_shares[id].end = static_cast<int>(qint64(chunks) * (id + 1) / participants);
+        }
+        m_pending = static_cast<int>(m_threads.size());
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    participate(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_pending == 0; });
+    lock.unlock();
+    m_isBusy = false;
+}
+
+void Executor::start(const int& count)
+{
+    m_shares = std::vector<Share>(qMax(1, count));
+    m_threadCount = static_cast<int>(m_shares.size());
+    m_isStopping = false;
+    // the threads are handed the current loop number, a loop started before they first lock the mutex still wakes them
+    for (int id = 1; id < threadCount(); id++)
+    {
+        m_threads.emplace_back(&Executor::work, this, id, m_generation);
+    }
+}
+
+void Executor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+void Executor::work(const int& id, const quint64& generation)
+{
+    quint64 seen = generation;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, &seen]() { return m_isStopping || m_generation != seen; });
+            if (m_isStopping) { return; }
+            seen = m_generation;
+        }
+        participate(id);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
+
+void Executor::participate(const int& id)
+{
+    int chunk = 0;
+    while (take(id, chunk))
+    {
+        const int begin = chunk * m_grain;
+        m_body(m_context, begin, qMin(begin + m_grain, m_count));
+    }
+}
+
+bool Executor::take(const int& id, int& chunk)
+{
+    Share& own = m_shares[id];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.begin < own.end)
+        {
+            chunk = own.begin++;
+            return true;
+        }
+    }
+    // the victims are visited from the next participant on, taking the back half of the first non-empty share
+    const int participants = threadCount();
+    for (int k = 1; k < participants; k++)
+    {
+        Share& victim = m_shares[(id + k) % participants];
+        int begin = 0;
+        int end = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin >= victim.end) { continue; }
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+        chunk = begin;
+        if (begin + 1 < end)
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin + 1;
+            own.end = end;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief The Executor class
+ * This class is a persistent pool of threads shared by the image kernels and the curve evaluation.
+ * A loop over a range is cut into chunks of a given grain, every thread starts on its own contiguous share
+ * of them, so neighbouring rows stay on one core, and a thread running out of chunks steals half of the
+ * remaining share of another one.
+ * The pool runs one loop at a time, a loop started while it is busy, from another thread or from inside
+ * a running loop, runs on its calling thread.
+ */
+class Executor
+{
+  public:
+    /*!
+     * \brief Returns the pool shared by the whole program
+     * \return A reference to the shared executor
+     */
+    static Executor& instance();
+    /*!
+     * \brief Constructs an Executor object
+     * \param threads The number of threads running a loop, the calling thread included
+     */
+    explicit Executor(const int& threads);
+    /*!
+     * \brief Destroys the Executor object, joining its threads
+     */
+    ~Executor();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    /*!
+     * \brief Returns the number of threads running a loop
+     * \return The number of threads, the calling thread included
+     */
+    int threadCount() const;
+    /*!
+     * \brief Sets the number of threads running a loop, waiting for the running loop to finish first,
+     * so it must not be called from inside a loop
+     * \param count The number of threads, the calling thread included
+     */
+    void setThreadCount(const int& count);
+    /*!
+     * \brief Returns the number of bytes a chunk of rows should touch
+     * \return The size of a tile in bytes
+     */
+    qsizetype tileBytes() const;
+    /*!
+     * \brief Sets the number of bytes a chunk of rows should touch
+     * \param bytes The size of a tile in bytes, about the share of the L2 cache of a core
+     */
+    void setTileBytes(const qsizetype& bytes);
+    /*!
+     * \brief Returns the number of rows that make up a tile
+     * \param rowBytes The number of bytes a row reads and writes
+     * \return The grain for a loop over the rows, at least one
+     */
+    int rowGrain(const qsizetype& rowBytes) const;
+    /*!
+     * \brief Calls a function for every chunk of a range in parallel and waits for all of them
+     * \param count The size of the range, which is [0, count)
+     * \param grain The size of a chunk
+     * \param function The callable taking the first index of a chunk and the index past its end
+     */
+    template <typename Function>
+    void forRange(const int& count, const int& grain, const Function& function)
+    {
+        run(count, grain, [](const void* context, const int& begin, const int& end) {
+            (*static_cast<const Function*>(context))(begin, end);
+        }, &function);
+    }
+
+  private:
+    /*!
+     * \brief The type-erased body of a loop
+     */
+    using Body = void (*)(const void* context, const int& begin, const int& end);
+    /*!
+     * \brief The chunks a thread has left, the owner takes them from the front and thieves from the back
+     */
+    struct Share
+    {
+        std::mutex mutex;
+        int begin = 0;
+        int end = 0;
+    };
+    /*!
+     * \brief The threads of the pool, the calling thread is the participant 0
+     */
+    std::vector<std::thread> m_threads;
+    /*!
+     * \brief The chunks of every participant
+     */
+    std::vector<Share> m_shares;
+    /*!
+     * \brief The number of participants, read without claiming the pool while the shares are rebuilt
+     */
+    std::atomic<int> m_threadCount;
+    /*!
+     * \brief Whether a loop is running
+     */
+    std::atomic<bool> m_isBusy;
+    /*!
+     * \brief The number of bytes a chunk of rows should touch
+     */
+    std::atomic<qsizetype> m_tileBytes;
+    /*!
+     * \brief Guards the state below
+     */
+    std::mutex m_mutex;
+    /*!
+     * \brief Wakes the threads for a new loop or for stopping
+     */
+    std::condition_variable m_wake;
+    /*!
+     * \brief Wakes the calling thread once every thread finished the loop
+     */
+    std::condition_variable m_done;
+    /*!
+     * \brief The number of the loop, which the threads wait to change
+     */
+    quint64 m_generation;
+    /*!
+     * \brief The number of threads still running the loop
+     */
+    int m_pending;
+    /*!
+     * \brief Whether the threads have to exit
+     */
+    bool m_isStopping;
+    /*!
+     * \brief The current loop
+     */
+    Body m_body;
+    const void* m_context;
+    int m_count;
+    int m_grain;
+    /*!
+     * \brief Runs a loop, on the pool if it is free
+     * \param count The size of the range
+     * \param grain The size of a chunk
+     * \param body The body of the loop
+     * \param context The callable the body forwards to
+     */
+    void run(const int& count, const int& grain, const Body& body, const void* context);
+    /*!
+     * \brief Starts the threads of the pool
+     * \param count The number of threads, the calling thread included
+     */
+    void start(const int& count);
+    /*!
+     * \brief Stops and joins the threads of the pool
+     */
+    void stop();
+    /*!
+     * \brief The loop of a thread of the pool
+     * \param id The index of the participant
+     * \param generation The number of the last loop before the thread started
+     */
+    void work(const int& id, const quint64& generation);
+    /*!
+     * \brief Runs chunks of the current loop until none are left
+     * \param id The index of the participant
+     */
+    void participate(const int& id);
+    /*!
+     * \brief Takes the next chunk of a participant, stealing when its own share is empty
+     * \param id The index of the participant
+     * \param chunk The taken chunk
+     * \return Whether a chunk was taken
+     */
+    bool take(const int& id, int& chunk);
+};
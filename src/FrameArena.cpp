@@ -0,0 +1,34 @@
+#include "FrameArena.h"
+
+FrameArena::FrameArena() : m_allocations(0) {}
+
+QImage& FrameArena::image(const Image& slot, const QSize& size, const QImage::Format& format)
+{
+    QImage& image = m_images[static_cast<int>(slot)];
+    if (image.size() != size || image.depth() != static_cast<int>(QImage::toPixelFormat(format).bitsPerPixel()))
+    {
+        image = QImage(size, format);
+        m_allocations++;
+    }
+    else if (image.format() != format)
+    {
+        image.reinterpretAsFormat(format);
+    }
+    return image;
+}
+
+std::vector<int>& FrameArena::table(const Table& slot, const int& count)
+{
+    std::vector<int>& table = m_tables[static_cast<int>(slot)];
+    if (table.size() < static_cast<std::size_t>(count))
+    {
+        table.resize(count);
+        m_allocations++;
+    }
+    return table;
+}
+
+int FrameArena::allocations() const
+{
+    return m_allocations;
+}
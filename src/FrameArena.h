@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QImage>
+#include <vector>
+
+/*!
+ * \brief The FrameArena class
+ * This class keeps the scratch buffers of the rotation pipeline between frames.
+ * Buffers are only reallocated when the requested size grows or changes, so a steady
+ * stream of frames of the same size reuses them without reallocating any.
+ * An arena must not be shared between threads running rotations at the same time.
+ */
+class FrameArena
+{
+  public:
+    /*!
+     * \enum Image
+     * \brief The enumeration of pooled images.
+     */
+    enum class Image { Sprite, Temp, Count };
+    /*!
+     * \enum Table
+     * \brief The enumeration of pooled integer tables.
+     */
+    enum class Table { Shifts, Weights, Spans, Count };
+    /*!
+     * \brief Constructs an empty FrameArena object
+     */
+    FrameArena();
+    /*!
+     * \brief Returns a pooled image of the requested size and format, with undefined contents
+     * \param slot The pooled image to return
+     * \param size The size of the image
+     * \param format The format of the image, only reinterpreted when the depth matches
+     * \return A reference to the pooled image, valid until the next call for the same slot
+     */
+    QImage& image(const Image& slot, const QSize& size, const QImage::Format& format);
+    /*!
+     * \brief Returns a pooled table with at least the requested number of integers, with undefined contents
+     * \param slot The pooled table to return
+     * \param count The number of integers
+     * \return A reference to the pooled table
+     */
+    std::vector<int>& table(const Table& slot, const int& count);
+    /*!
+     * \brief Returns the number of buffers allocated so far
+     * \return The allocation counter, constant once the frame sizes are steady
+     */
+    int allocations() const;
+
+  private:
+    /*!
+     * \brief The pooled images
+     */
+    QImage m_images[static_cast<int>(Image::Count)];
+    /*!
+     * \brief The pooled tables
+     */
+    std::vector<int> m_tables[static_cast<int>(Table::Count)];
+    /*!
+     * \brief The number of buffers allocated so far
+     */
+    int m_allocations;
+};
@@ -0,0 +1,82 @@
+#include <algorithm>
+
+#include "PointGrid.h"
+
+PointGrid::PointGrid(const QSize& size, const int& cell) : m_cell(cell)
+{
+    m_columns = qMax(1, (size.width() + cell - 1) / cell);
+    m_rows = qMax(1, (size.height() + cell - 1) / cell);
+    m_cells = QList<QList<int>>(m_columns * m_rows);
+}
+
+void PointGrid::build(const QList<QPoint>& points)
+{
+    for (QList<int>& cell : m_cells)
+    {
+        cell.clear();
+    }
+    for (int i = 0; i < points.count(); i++)
+    {
+        m_cells[cellOf(points.at(i))].append(i);
+    }
+}
+
+void PointGrid::move(const int& idx, const QPoint& from, const QPoint& to)
+{
+    const int source = cellOf(from);
+    const int target = cellOf(to);
+    if (source == target) { return; }
+    QList<int>& cell = m_cells[source];
+    // the order within a cell does not matter, the last index takes the place of the removed one
+    const qsizetype i = cell.indexOf(idx);
+    if (i != -1)
+    {
+        cell[i] = cell.constLast();
+        cell.removeLast();
+    }
+    m_cells[target].append(idx);
+}
+
+int PointGrid::nearest(const QList<QPoint>& points, const QPoint& p, const int& margin) const
+{
+    int best = -1;
+    qint64 bestDistance = 0;
+    for (int r = row(p.y() - margin); r <= row(p.y() + margin); r++)
+    {
+        for (int c = column(p.x() - margin); c <= column(p.x() + margin); c++)
+        {
+            for (const int& i : m_cells.at(r * m_columns + c))
+            {
+                const QPoint d = points.at(i) - p;
+                if (qAbs(d.x()) > margin || qAbs(d.y()) > margin) { continue; }
+                const qint64 distance = qint64(d.x()) * d.x() + qint64(d.y()) * d.y();
+                if (best == -1 || distance < bestDistance || (distance == bestDistance && i < best))
+                {
+                    best = i;
+                    bestDistance = distance;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+QList<int> PointGrid::inside(const QList<QPoint>& points, const QRect& rect) const
+{
+    QList<int> indices;
+    for (int r = row(rect.top()); r <= row(rect.bottom()); r++)
+    {
+        for (int c = column(rect.left()); c <= column(rect.right()); c++)
+        {
+            for (const int& i : m_cells.at(r * m_columns + c))
+            {
+                if (rect.contains(points.at(i)))
+                {
+                    indices.append(i);
+                }
+            }
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
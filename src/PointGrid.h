@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QList>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+
+/*!
+ * \brief The PointGrid class
+ * This class is a uniform grid over the scene holding the indices of the control points, for hit testing.
+ * Points outside of the scene are kept in the border cells, so every point can be found.
+ * A lookup visits the cells around the queried area only, which takes constant time for evenly spread points.
+ */
+class PointGrid
+{
+  public:
+    /*!
+     * \brief Constructs an empty PointGrid object
+     * \param size The size of the area covered by the cells
+     * \param cell The side of a cell
+     */
+    explicit PointGrid(const QSize& size = QSize(800, 800), const int& cell = 20);
+    /*!
+     * \brief Fills the grid with the points
+     * \param points The points, their indices in the list are stored
+     */
+    void build(const QList<QPoint>& points);
+    /*!
+     * \brief Moves a point to another cell if needed
+     * \param idx The index of the point
+     * \param from The previous position of the point
+     * \param to The new position of the point
+     */
+    void move(const int& idx, const QPoint& from, const QPoint& to);
+    /*!
+     * \brief Finds the point closest to a position, among the ones within a margin on both axes
+     * \param points The points the grid was built from
+     * \param p The position
+     * \param margin The largest distance on each axis
+     * \return The index of the closest point, the lowest index on a tie, or -1 if no point is within the margin
+     */
+    int nearest(const QList<QPoint>& points, const QPoint& p, const int& margin) const;
+    /*!
+     * \brief Finds all points inside a rectangle
+     * \param points The points the grid was built from
+     * \param rect The rectangle, its edges included
+     * \return The indices of the points in ascending order
+     */
+    QList<int> inside(const QList<QPoint>& points, const QRect& rect) const;
+
+  private:
+    /*!
+     * \brief The side of a cell
+     */
+    int m_cell;
+    /*!
+     * \brief The number of columns of the grid
+     */
+    int m_columns;
+    /*!
+     * \brief The number of rows of the grid
+     */
+    int m_rows;
+    /*!
+     * \brief The indices of the points in every cell, row-major
+     */
+    QList<QList<int>> m_cells;
+    /*!
+     * \brief Returns the column of a x-coordinate, clamped to the grid
+     * \param x The x-coordinate
+     * \return The column
+     */
+    inline int column(const int& x) const
+    {
+        return qBound(0, x < 0 ? -1 : x / m_cell, m_columns - 1);
+    }
+    /*!
+     * \brief Returns the row of a y-coordinate, clamped to the grid
+     * \param y The y-coordinate
+     * \return The row
+     */
+    inline int row(const int& y) const
+    {
+        return qBound(0, y < 0 ? -1 : y / m_cell, m_rows - 1);
+    }
+    /*!
+     * \brief Returns the cell holding a point
+     * \param p The point
+     * \return The index of the cell
+     */
+    inline int cellOf(const QPoint& p) const
+    {
+        return row(p.y()) * m_columns + column(p.x());
+    }
+};
@@ -0,0 +1,21 @@
+#include "RandomStream.h"
+
+RandomStream::RandomStream(const quint64& seed, const quint64& position) : m_seed(seed), m_position(position) {}
+
+quint64 RandomStream::next()
+{
+    // the state of SplitMix64 is the seed plus a multiple of the golden ratio, so it follows from the position alone,
+    // the number at a position is hashed from the state after position + 1 steps, then the stream advances
+    quint64 z = m_seed + (m_position + 1) * 0x9e3779b97f4a7c15ull;
+    m_position++;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+int RandomStream::bounded(const int& lowest, const int& highest)
+{
+    // the upper half of the number scaled to the size of the range by a multiplication instead of a modulo
+    const quint64 range = static_cast<quint64>(qint64(highest) - qint64(lowest));
+    return static_cast<int>(lowest + static_cast<qint64>(((next() >> 32) * range) >> 32));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QtGlobal>
+
+/*!
+ * \brief The RandomStream class
+ * This class is a counter-based generator: the number at the position p, counted from 0, is the output of SplitMix64
+ * seeded with the seed after p + 1 steps, so any position of the sequence is reached without drawing the numbers before it.
+ * Every worker of a parallel loop opens the stream at the positions of its own items, and the numbers an item
+ * gets depend only on the seed and its index, not on how the loop is split between threads.
+ */
+class RandomStream
+{
+  public:
+    /*!
+     * \brief Constructs a RandomStream object
+     * \param seed The seed of the sequence
+     * \param position The position of the first number drawn, the number of values of the sequence to skip
+     */
+    RandomStream(const quint64& seed, const quint64& position);
+    /*!
+     * \brief Draws the next number of the sequence
+     * \return A 64-bit number
+     */
+    quint64 next();
+    /*!
+     * \brief Draws the next number of the sequence, scaled to a range
+     * \param lowest The lowest number of the range
+     * \param highest The number past the end of the range, larger than the lowest one
+     * \return A number in [lowest, highest)
+     */
+    int bounded(const int& lowest, const int& highest);
+
+  private:
+    /*!
+     * \brief The seed of the sequence
+     */
+    quint64 m_seed;
+    /*!
+     * \brief The position of the next number, the number of values drawn so far, skipped ones included
+     */
+    quint64 m_position;
+};
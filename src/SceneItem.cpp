@@ -0,0 +1,120 @@
+#include <QSGSimpleTextureNode>
+
+#include "SceneItem.h"
+#include "SceneManager.h"
+#include "TileTexture.h"
+
+SceneItem::SceneItem(QQuickItem* parent) : QQuickItem(parent), m_frame(Frame::Scene)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+}
+
+QObject* SceneItem::manager() const
+{
+    return m_manager;
+}
+
+void SceneItem::setManager(QObject* newManager)
+{
+    SceneManager* manager = qobject_cast<SceneManager*>(newManager);
+    if (m_manager == manager) { return; }
+    if (m_manager)
+    {
+        disconnect(m_manager, nullptr, this, nullptr);
+    }
+    m_manager = manager;
+    if (m_manager)
+    {
+        connect(m_manager, &SceneManager::sceneChanged, this, [this]() {
+            if (m_frame == Frame::Scene) { markDirty(m_manager->dirtyRect()); }
+        });
+        connect(m_manager, &SceneManager::imageChanged, this, [this]() {
+            if (m_frame == Frame::Image) { markDirty(image().rect()); }
+        });
+        markDirty(image().rect());
+    }
+    else
+    {
+        update();
+    }
+    emit managerChanged();
+}
+
+SceneItem::Frame SceneItem::frame() const
+{
+    return m_frame;
+}
+
+void SceneItem::setFrame(const Frame& newFrame)
+{
+    if (m_frame == newFrame) { return; }
+    m_frame = newFrame;
+    if (m_manager)
+    {
+        markDirty(image().rect());
+    }
+    emit frameChanged();
+}
+
+QSGNode* SceneItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data)
+    if (!m_manager)
+    {
+        delete oldNode;
+        return nullptr;
+    }
+
+    // the GUI thread is blocked here, the tiles keep a shallow copy of the frame until their upload is recorded,
+    // and the manager paints the next frame into its other buffer
+    const QImage frame = image();
+    QSGNode* node = oldNode;
+    if (!node || frame.size() != m_tiledSize)
+    {
+        delete node;
+        node = new QSGNode();
+        for (int y = 0; y < frame.height(); y += m_tileSize)
+        {
+            for (int x = 0; x < frame.width(); x += m_tileSize)
+            {
+                const QRect rect = QRect(x, y, m_tileSize, m_tileSize) & frame.rect();
+                QSGSimpleTextureNode* tile = new QSGSimpleTextureNode();
+                tile->setTexture(new TileTexture(rect, m_frame == Frame::Image));
+                tile->setOwnsTexture(true);
+                tile->setFiltering(QSGTexture::Linear);
+                node->appendChildNode(tile);
+            }
+        }
+        m_tiledSize = frame.size();
+        m_dirty = frame.rect();
+    }
+
+    const qreal sx = width() / frame.width();
+    const qreal sy = height() / frame.height();
+    const int columns = (frame.width() + m_tileSize - 1) / m_tileSize;
+    int i = 0;
+    for (QSGNode* child = node->firstChild(); child; child = child->nextSibling(), i++)
+    {
+        QSGSimpleTextureNode* tile = static_cast<QSGSimpleTextureNode*>(child);
+        const QRect rect = QRect((i % columns) * m_tileSize, (i / columns) * m_tileSize, m_tileSize, m_tileSize) & frame.rect();
+        // only the changed part of the tile is uploaded, into the texture it already has
+        if (static_cast<TileTexture*>(tile->texture())->setSource(frame, m_dirty))
+        {
+            tile->markDirty(QSGNode::DirtyMaterial);
+        }
+        tile->setRect(QRectF(rect.x() * sx, rect.y() * sy, rect.width() * sx, rect.height() * sy));
+    }
+    m_dirty = QRect();
+    return node;
+}
+
+void SceneItem::markDirty(const QRect& rect)
+{
+    m_dirty |= rect;
+    update();
+}
+
+QImage SceneItem::image() const
+{
+    return m_frame == Frame::Scene ? *m_manager->scene : *m_manager->image;
+}
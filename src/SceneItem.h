@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QImage>
+#include <QPointer>
+#include <QQuickItem>
+
+class SceneManager;
+
+/*!
+ * \brief The SceneItem class
+ * This class shows one of the images of the SceneManager as textures in the scene graph.
+ * The image is split into tiles, each with a texture of its own, and only the parts of the tiles
+ * touched by the dirty rects reported by the manager are uploaded again, straight from the image.
+ */
+class SceneItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject* manager READ manager WRITE setManager NOTIFY managerChanged)
+    Q_PROPERTY(Frame frame READ frame WRITE setFrame NOTIFY frameChanged)
+  public:
+    /*!
+     * \enum Frame
+     * \brief The enumeration of images the item can show.
+     */
+    enum class Frame { Scene, Image };
+    Q_ENUM(Frame)
+    /*!
+     * \brief Constructs a SceneItem object
+     * \param parent A pointer to the parent QQuickItem.
+     */
+    explicit SceneItem(QQuickItem* parent = nullptr);
+
+    QObject* manager() const;
+    void setManager(QObject* newManager);
+
+    Frame frame() const;
+    void setFrame(const Frame& newFrame);
+
+  signals:
+    void managerChanged();
+    void frameChanged();
+
+  protected:
+    /*!
+     * \brief Updates the dirty tiles with the latest frame
+     * \param oldNode The node returned by the previous call
+     * \param data Unused
+     * \return The node holding the tiles
+     */
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+
+  private:
+    /*!
+     * \brief The manager owning the images
+     */
+    QPointer<SceneManager> m_manager;
+    /*!
+     * \brief The image shown
+     */
+    Frame m_frame;
+    /*!
+     * \brief The side of the square tiles
+     */
+    static constexpr int m_tileSize = 128;
+    /*!
+     * \brief The area of the image changed since the last upload
+     */
+    QRect m_dirty;
+    /*!
+     * \brief The size of the image the tile nodes were made for
+     */
+    QSize m_tiledSize;
+    /*!
+     * \brief Schedules an upload of the tiles in the given area for the next frame
+     * \param rect The changed area of the image
+     */
+    void markDirty(const QRect& rect);
+    /*!
+     * \brief Returns the image shown
+     * \return A shallow copy of the image
+     */
+    QImage image() const;
+};
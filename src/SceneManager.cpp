@@ -1,77 +1,190 @@
-#include <QApplication>
-#include <QElapsedTimer>
-#include <QEventLoop>
-#include <QThread>
+#include <QRandomGenerator>
+#include <cmath>
+#include <cstring>
 
 #include "SceneManager.h"
 #include "Algorithms.h"
 
-SceneManager::SceneManager(QObject* parent, QApplication* app) : QObject(parent), m_app(app), m_curve(PascalTriangle(m_maxPoints - 1), 3),
-      m_isDragging(false), m_isPolylineVisible(true), m_loaded(false), m_algorithm(Algorithm::Enum::Naive), m_animation(Animation::Enum::Rotation)
+SceneManager::SceneManager(const quint32& seed, QObject* parent) : QObject(parent), m_deadline(0), m_curve(new BezierCurve(3, seed)),
+      m_spriteTheta(0.0f), m_isDragging(false), m_isPlaying(false), m_isPolylineVisible(true), m_loaded(false), m_isLayerDirty(true), m_isAtlasEnabled(false), m_isSpriteValid(false), m_targetFps(33), m_maxPoints(20), m_droppedFrames(0), m_seed(seed),
+      m_algorithm(Algorithm::Enum::Naive), m_animation(Animation::Enum::Rotation), m_curveType(CurveType::Enum::Bezier),
+      m_format(QImage::Format_ARGB32_Premultiplied)
 {
-    image = QSharedPointer<QImage>(new QImage(m_imageSize, QImage::Format_ARGB32));
-    scene = QSharedPointer<QImage>(new QImage(m_sceneSize, QImage::Format_ARGB32), [this](QImage* image) {
-        // the painter must be freed before freeing the device
-        m_painter.end();
-        delete image;
-    });
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &SceneManager::tick);
+
+    m_maxPoints = qBound(3, QSettings().value("curve/maxPoints", 20).toInt(), m_pointsLimit);
+    m_intValidator.setTop(m_maxPoints);
+
+    image = QSharedPointer<QImage>(new QImage(m_imageSize, m_format));
+    scene = QSharedPointer<QImage>(new QImage(m_sceneSize, m_format));
+    m_back = QImage(m_sceneSize, m_format);
+
+    m_layer = QImage(m_sceneSize, m_format);
 
     image->fill(m_white);
     scene->fill(m_white);
-    m_painter.begin(scene.get());
-    m_painter.setRenderHint(QPainter::Antialiasing, true);
     paint();
 }
 
 void SceneManager::paint()
 {
-    scene->fill(m_white);
-    m_curve.paint(m_painter, m_isPolylineVisible);
+    if (m_isLayerDirty)
+    {
+        paintLayer();
+    }
+    // the back buffer still holds the frame before last, only its sprite has to be wiped
+    restore(m_backSprite);
+
+    QRect sprite;
+    m_painter.begin(&m_back);
+    m_painter.setRenderHint(QPainter::Antialiasing, true);
+    // the sprite sits between pixels wherever the curve puts it, and is interpolated there
+    m_painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
     if (m_loaded)
     {
         if (m_animation == Animation::Enum::Rotation)
         {
-            QPoint p = m_curve.current();
+            QPointF p = m_curve->current();
             float theta = m_isPlaying ? m_circle.next() : m_circle.current();
-            draw(p, theta);
+            sprite = draw(p, theta);
         }
         else
         {
-            QPoint p = m_isPlaying ? m_curve.next() : m_curve.current();
-            draw(p, m_curve.currentAngle());
+            QPointF p = m_isPlaying ? m_curve->next() : m_curve->current();
+            sprite = draw(p, m_curve->currentAngle());
         }
     }
+    m_painter.end();
+
+    // against the presented frame, only its sprite and the new one changed
+    m_dirtyRect = m_sceneSprite | sprite;
+    m_backSprite = sprite;
+    present();
+}
+
+QRect SceneManager::dirtyRect() const
+{
+    return m_dirtyRect;
+}
+
+void SceneManager::present()
+{
+    // the tiles of a SceneItem hold a shallow copy of the presented frame until their upload is recorded,
+    // painting only ever goes into the other buffer, and detaches it rather than overwriting a frame still held
+    scene->swap(m_back);
+    std::swap(m_sceneSprite, m_backSprite);
+}
+
+void SceneManager::invalidateLayer()
+{
+    m_isLayerDirty = true;
+}
+
+void SceneManager::paintLayer()
+{
+    m_layer.fill(m_white);
+    QPainter painter(&m_layer);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    m_curve->paint(painter, m_isPolylineVisible);
+    painter.end();
+
+    m_isLayerDirty = false;
+    // neither buffer matches the new layer anywhere anymore
+    m_backSprite = m_layer.rect();
+    m_sceneSprite = m_layer.rect();
+}
+
+void SceneManager::restore(const QRect& rect)
+{
+    const QRect area = rect & m_back.rect();
+    if (area.isEmpty()) { return; }
+    const qsizetype bytes = area.width() * qsizetype(sizeof(QRgb));
+    for (int y = area.top(); y <= area.bottom(); y++)
+    {
+        std::memcpy(m_back.scanLine(y) + area.left() * sizeof(QRgb), m_layer.constScanLine(y) + area.left() * sizeof(QRgb), bytes);
+    }
+}
+
+void SceneManager::setPixelFormat(const QImage::Format& format)
+{
+    if (m_format == format) { return; }
+    m_format = format;
+    image->convertTo(m_format);
+    scene->convertTo(m_format);
+    m_back.convertTo(m_format);
+    m_layer.convertTo(m_format);
+    m_isSpriteValid = false;
+    resetAtlas();
+    invalidateLayer();
+    paint();
 }
 
 void SceneManager::play()
 {
-    const int frame = 30;
-    QElapsedTimer timer;
-    timer.start();
-    while (m_isPlaying)
+    m_droppedFrames = 0;
+    emit droppedFramesChanged();
+    m_clock.start();
+    m_deadline = 0;
+    m_timer.start(0);
+}
+
+void SceneManager::tick()
+{
+    const qint64 period = 1'000'000'000 / m_targetFps;
+    const qint64 late = m_clock.nsecsElapsed() - m_deadline;
+    if (late >= period)
     {
-        timer.restart();
-        paint();
-        const int remaining = frame - timer.elapsed();
-        const int toWait = remaining < 0 ? 0 : remaining;
-        QThread::msleep(toWait);
-        emit sceneChanged();
-        m_app->processEvents(QEventLoop::AllEvents);
+        // whole periods that passed without a frame are dropped, the schedule restarts from the latest one
+        const qint64 missed = late / period;
+        m_droppedFrames += static_cast<int>(missed);
+        m_deadline += missed * period;
+        emit droppedFramesChanged();
     }
+
+    paint();
+    emit sceneChanged();
+
+    // the deadlines advance by exact periods, so rounding the wait to milliseconds never accumulates into drift
+    m_deadline += period;
+    const qint64 remaining = m_deadline - m_clock.nsecsElapsed();
+    m_timer.start(remaining > 0 ? remaining / 1'000'000 : 0);
 }
 
 // === SLOTS ===
 
-void SceneManager::checkPoints(int x, int y)
+bool SceneManager::checkPoints(int x, int y)
+{
+    m_curve->select(x, y);
+    invalidateLayer();
+    paint();
+    emit sceneChanged();
+    return !m_curve->selection().isEmpty();
+}
+
+void SceneManager::selectPoints(int x1, int y1, int x2, int y2)
 {
-    m_curve.select(x, y);
+    m_curve->selectRect(QRect(QPoint(x1, y1), QPoint(x2, y2)));
+    invalidateLayer();
     paint();
     emit sceneChanged();
 }
 
+bool SceneManager::jumpTo(int x, int y, int margin)
+{
+    const CurveProjection projection = m_curve->projectToCurve(x, y);
+    if (projection.index == -1 || (margin >= 0 && projection.distance > margin)) { return false; }
+    m_curve->setDistance(projection.s);
+    paint();
+    emit sceneChanged();
+    return true;
+}
+
 void SceneManager::movePoint(int x, int y)
 {
-    m_curve.drag(x, y);
+    m_curve->drag(x, y);
+    invalidateLayer();
     paint();
     emit sceneChanged();
 }
@@ -84,17 +197,29 @@ void SceneManager::generate(QString count)
     {
         validated = count.toInt();
     }
-    if (state != QValidator::State::Acceptable || validated < 3 || validated > 20)
+    if (state != QValidator::State::Acceptable || validated < 3 || validated > m_maxPoints)
     {
         QMessageBox::warning(nullptr, tr("Warning"), tr("The number of the points is invalid.\n"
-                                                        "Please enter a number between 3 and 20."));
+                                                        "Please enter a number between 3 and %1.").arg(m_maxPoints));
+        return;
+    }
+    if (m_curveType == CurveType::Enum::Bezier && validated > m_bezierLimit)
+    {
+        QMessageBox::warning(nullptr, tr("Warning"), tr("The Bezier curve is limited to %1 points.\n"
+                                                        "Please switch to the spline for more.").arg(m_bezierLimit));
         return;
     }
-    m_curve.generate(validated);
+    m_curve->generate(validated, m_seed);
+    invalidateLayer();
     paint();
     emit sceneChanged();
 }
 
+void SceneManager::randomizeSeed()
+{
+    setSeed(QRandomGenerator::global()->generate());
+}
+
 void SceneManager::load()
 {
     QString fileName = QFileDialog::getOpenFileName(nullptr, tr("Open File"), "/home", tr("Images (*.png *.jpg)"));
@@ -102,15 +227,18 @@ void SceneManager::load()
     {
         image->load(fileName);
         *image = image->scaled(m_imageSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        image->convertTo(QImage::Format_ARGB32);
+        // converted once here, so neither the rotations nor the painter convert the sprite every frame
+        image->convertTo(m_format);
         m_loaded = true;
     }
     else
     {
-        *image = QImage(m_imageSize, QImage::Format_ARGB32);
+        *image = QImage(m_imageSize, m_format);
         image->fill(m_white);
         m_loaded = false;
     }
+    m_isSpriteValid = false;
+    resetAtlas();
     emit imageChanged();
     paint();
     emit sceneChanged();
@@ -118,7 +246,7 @@ void SceneManager::load()
 
 void SceneManager::create()
 {
-    QImage creation(m_imageSize, QImage::Format_ARGB32);
+    QImage creation(m_imageSize, m_format);
     const float hStep = 360.0f / creation.width();
     const float sStep = 4.0f / creation.height();
     const float vStep =  creation.width() / 4.0f;
@@ -149,25 +277,56 @@ void SceneManager::create()
     }
     *image = creation;
     m_loaded = true;
+    m_isSpriteValid = false;
+    resetAtlas();
     emit imageChanged();
 
     paint();
     emit sceneChanged();
 }
 
-void SceneManager::draw(const QPoint& p, const float& theta)
+QRect SceneManager::draw(const QPointF& p, const float& theta)
+{
+    // the sprites are drawn one to one, only the part of them the rotation covered
+    const QPointF origin = p - QPointF(m_imageSize.width(), m_imageSize.height());
+    QRectF rect;
+    if (m_isAtlasEnabled)
+    {
+        const QImage sprite = m_atlas.sprite(theta);
+        rect = QRectF(origin + sprite.offset(), sprite.size());
+        m_painter.drawImage(rect.topLeft(), sprite);
+    }
+    else
+    {
+        // fetched in the premultiplied format every algorithm leaves it in, so a reused sprite is never reinterpreted
+        QImage& dest = m_arena.image(FrameArena::Image::Sprite, 2 * m_imageSize, QImage::Format_ARGB32_Premultiplied);
+        // along straight stretches of the curve the angle barely moves, and the last sprite still fits,
+        // the angles are compared modulo a full turn, so wrapping from 2 pi to 0 keeps it as well
+        if (!m_isSpriteValid || qAbs(std::remainder(theta - m_spriteTheta, 2.0f * float(M_PI))) > m_angleTolerance)
+        {
+            m_spriteRect = Rotate(dest, image, m_algorithm, theta, m_imageSize.width() / 2, m_arena);
+            m_spriteTheta = theta;
+            m_isSpriteValid = true;
+        }
+        rect = QRectF(m_spriteRect).translated(origin);
+        m_painter.drawImage(rect.topLeft(), dest, m_spriteRect);
+    }
+    if (rect.isEmpty()) { return QRect(); }
+    // the pixels the sprite partly covers, and one pixel of slack for the antialiased edges
+    return rect.toAlignedRect().adjusted(-1, -1, 1, 1) & m_back.rect();
+}
+
+void SceneManager::resetAtlas()
 {
-    QImage dest(2 * m_imageSize, QImage::Format_ARGB32);
-    if (m_algorithm == Algorithm::Enum::Naive)
+    if (m_isAtlasEnabled && m_loaded)
     {
-        Naive(dest, image, theta, m_imageSize.width() / 2);
+        m_atlas.reset(image, m_algorithm);
+        m_atlas.prerender(m_circle.degrees());
     }
     else
     {
-        Shear(dest, image, theta, m_imageSize.width() / 2);
+        m_atlas.clear();
     }
-    QRect rect = getRect(p.x(), p.y());
-    m_painter.drawImage(rect, dest);
 }
 
 QColor SceneManager::HSV2RGB(const float& hue, const float& saturation, const float& value)
@@ -231,6 +390,10 @@ void SceneManager::startDragging()
 void SceneManager::stopDragging()
 {
     m_isDragging = false;
+    m_curve->finishDrag();
+    invalidateLayer();
+    paint();
+    emit sceneChanged();
 }
 
 // === PROPERTIES ===
@@ -257,7 +420,14 @@ void SceneManager::setIsPlaying(bool newIsPlaying)
     if (m_isPlaying == newIsPlaying) { return; }
     m_isPlaying = newIsPlaying;
     emit isPlayingChanged();
-    if (m_isPlaying) { play(); }
+    if (m_isPlaying)
+    {
+        play();
+    }
+    else
+    {
+        m_timer.stop();
+    }
 }
 
 bool SceneManager::isPolylineVisible() const
@@ -271,6 +441,7 @@ void SceneManager::setIsPolylineVisible(bool newIsPolylineVisible)
     m_isPolylineVisible = newIsPolylineVisible;
     emit isPolylineVisibleChanged();
 
+    invalidateLayer();
     paint();
     emit sceneChanged();
 }
@@ -284,6 +455,8 @@ void SceneManager::setAlgorithm(const Algorithm::Enum& newAlgorithm)
 {
     if (m_algorithm == newAlgorithm) { return; }
     m_algorithm = newAlgorithm;
+    m_isSpriteValid = false;
+    resetAtlas();
     emit algorithmChanged();
 }
 
@@ -299,4 +472,135 @@ void SceneManager::setAnimation(const Animation::Enum& newAnimation)
     emit animationChanged();
 }
 
+bool SceneManager::isAtlasEnabled() const
+{
+    return m_isAtlasEnabled;
+}
+
+void SceneManager::setIsAtlasEnabled(bool newIsAtlasEnabled)
+{
+    if (m_isAtlasEnabled == newIsAtlasEnabled) { return; }
+    m_isAtlasEnabled = newIsAtlasEnabled;
+    resetAtlas();
+    emit isAtlasEnabledChanged();
+}
+
+int SceneManager::atlasBudget() const
+{
+    return m_atlas.budget() / (1024 * 1024);
+}
+
+void SceneManager::setAtlasBudget(int newAtlasBudget)
+{
+    if (atlasBudget() == newAtlasBudget) { return; }
+    m_atlas.setBudget(qsizetype(newAtlasBudget) * 1024 * 1024);
+    emit atlasBudgetChanged();
+}
+
+int SceneManager::targetFps() const
+{
+    return m_targetFps;
+}
+
+void SceneManager::setTargetFps(int newTargetFps)
+{
+    newTargetFps = qBound(1, newTargetFps, 1000);
+    if (m_targetFps == newTargetFps) { return; }
+    m_targetFps = newTargetFps;
+    if (m_isPlaying)
+    {
+        // restart the schedule, the old deadlines were spaced for the previous rate
+        m_deadline = m_clock.nsecsElapsed();
+    }
+    emit targetFpsChanged();
+}
+
+int SceneManager::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+int SceneManager::arenaAllocations() const
+{
+    return m_arena.allocations();
+}
+
+qreal SceneManager::curveTolerance() const
+{
+    return m_curve->tolerance();
+}
+
+void SceneManager::setCurveTolerance(qreal newCurveTolerance)
+{
+    newCurveTolerance = qBound(0.05, newCurveTolerance, 10.0);
+    if (qFuzzyCompare(curveTolerance(), newCurveTolerance)) { return; }
+    m_curve->setTolerance(newCurveTolerance);
+    emit curveToleranceChanged();
+
+    invalidateLayer();
+    paint();
+    emit sceneChanged();
+}
 
+int SceneManager::maxPoints() const
+{
+    return m_maxPoints;
+}
+
+void SceneManager::setMaxPoints(int newMaxPoints)
+{
+    newMaxPoints = qBound(3, newMaxPoints, m_pointsLimit);
+    if (m_maxPoints == newMaxPoints) { return; }
+    m_maxPoints = newMaxPoints;
+    m_intValidator.setTop(m_maxPoints);
+    QSettings().setValue("curve/maxPoints", m_maxPoints);
+    emit maxPointsChanged();
+}
+
+CurveType::Enum SceneManager::curveType() const
+{
+    return m_curveType;
+}
+
+void SceneManager::setCurveType(const CurveType::Enum& newCurveType)
+{
+    if (m_curveType == newCurveType) { return; }
+    const QList<QPoint> points = m_curve->controlPoints();
+    if (newCurveType == CurveType::Enum::Bezier && points.count() > m_bezierLimit)
+    {
+        QMessageBox::warning(nullptr, tr("Warning"), tr("The Bezier curve is limited to %1 points.\n"
+                                                        "Please generate a shorter curve first.").arg(m_bezierLimit));
+        // the controls are bound to the type, which did not change
+        emit curveTypeChanged();
+        return;
+    }
+    const float tolerance = m_curve->tolerance();
+    if (newCurveType == CurveType::Enum::Bezier)
+    {
+        m_curve.reset(new BezierCurve());
+    }
+    else
+    {
+        m_curve.reset(new SplineCurve());
+    }
+    m_curve->setTolerance(tolerance);
+    m_curve->setControlPoints(points);
+    m_curveType = newCurveType;
+    emit curveTypeChanged();
+
+    invalidateLayer();
+    paint();
+    emit sceneChanged();
+}
+
+quint32 SceneManager::seed() const
+{
+    return m_seed;
+}
+
+void SceneManager::setSeed(quint32 newSeed)
+{
+    if (m_seed == newSeed) { return; }
+    m_seed = newSeed;
+    emit seedChanged();
+}
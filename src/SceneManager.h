@@ -3,10 +3,16 @@
 #include <QIntValidator>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QTimer>
 
 #include "BezierCurve.h"
+#include "SplineCurve.h"
 #include "Circle.h"
 #include "Enums.h"
+#include "FrameArena.h"
+#include "SpriteAtlas.h"
 
 /*!
  * \brief The SceneManager class
@@ -21,27 +27,47 @@ class SceneManager : public QObject
     Q_PROPERTY(bool isPlaying READ isPlaying WRITE setIsPlaying NOTIFY isPlayingChanged)
     Q_PROPERTY(Algorithm::Enum algorithm READ algorithm WRITE setAlgorithm NOTIFY algorithmChanged)
     Q_PROPERTY(Animation::Enum animation READ animation WRITE setAnimation NOTIFY animationChanged)
+    Q_PROPERTY(bool isAtlasEnabled READ isAtlasEnabled WRITE setIsAtlasEnabled NOTIFY isAtlasEnabledChanged)
+    Q_PROPERTY(int atlasBudget READ atlasBudget WRITE setAtlasBudget NOTIFY atlasBudgetChanged)
+    Q_PROPERTY(int targetFps READ targetFps WRITE setTargetFps NOTIFY targetFpsChanged)
+    Q_PROPERTY(int droppedFrames READ droppedFrames NOTIFY droppedFramesChanged)
+    Q_PROPERTY(int maxPoints READ maxPoints WRITE setMaxPoints NOTIFY maxPointsChanged)
+    Q_PROPERTY(qreal curveTolerance READ curveTolerance WRITE setCurveTolerance NOTIFY curveToleranceChanged)
+    Q_PROPERTY(CurveType::Enum curveType READ curveType WRITE setCurveType NOTIFY curveTypeChanged)
+    Q_PROPERTY(quint32 seed READ seed WRITE setSeed NOTIFY seedChanged)
   public:
     /*!
-     * \brief An image representing the scene
+     * \brief An image representing the scene, the last completed frame
+     * All images of the scene are premultiplied, which is the format the rotations and the painter work in.
      */
     QSharedPointer<QImage> scene;
     /*!
-     * \brief An image selected by user
+     * \brief An image selected by user, premultiplied once when it is loaded or created
      */
     QSharedPointer<QImage> image;
     /*!
      * \brief Constructs a SceneManager object
+     * \param seed The seed of the first curve.
      * \param parent A pointer to the parent QObject.
-     * \param app A pointer to the QApplication.
      */
-    explicit SceneManager(QObject* parent = nullptr, QApplication* app = nullptr);
+    explicit SceneManager(const quint32& seed = 0, QObject* parent = nullptr);
     /*!
      * \brief Paints the scene
      */
     void paint();
     /*!
-     * \brief Plays the animation
+     * \brief Returns the area in which the scene differs from the previous one
+     * \return A QRect representing the area changed by the last paint
+     */
+    QRect dirtyRect() const;
+    /*!
+     * \brief Converts the image and the buffers of the scene to another format, which the benchmark uses
+     * to compare the straight-alpha pipeline with the premultiplied one
+     * \param format The format of the image, the scene, the back buffer and the layer
+     */
+    void setPixelFormat(const QImage::Format& format);
+    /*!
+     * \brief Starts the frame timer, the animation then advances once per frame period
      */
     void play();
 
@@ -60,13 +86,83 @@ class SceneManager : public QObject
     Animation::Enum animation() const;
     void setAnimation(const Animation::Enum& newAnimation);
 
+    bool isAtlasEnabled() const;
+    void setIsAtlasEnabled(bool newIsAtlasEnabled);
+
+    /*!
+     * \brief Returns the memory budget of the sprite atlas
+     * \return The budget in MiB
+     */
+    int atlasBudget() const;
+    void setAtlasBudget(int newAtlasBudget);
+
+    int targetFps() const;
+    void setTargetFps(int newTargetFps);
+
+    /*!
+     * \brief Returns the number of frames that missed their deadline since the animation started
+     * \return The number of dropped frames
+     */
+    int droppedFrames() const;
+    /*!
+     * \brief Returns the number of scratch buffers the rotations allocated so far
+     * Only the pooled buffers of the arena are counted, not the other allocations of a frame.
+     * \return The allocation counter of the arena, constant in a steady animation
+     */
+    int arenaAllocations() const;
+
+    /*!
+     * \brief Returns the maximal distance between the painted curve and the exact one
+     * \return The tolerance in pixels
+     */
+    qreal curveTolerance() const;
+    void setCurveTolerance(qreal newCurveTolerance);
+
+    /*!
+     * \brief Returns the largest number of control points a curve can be generated with, kept in the settings
+     * \return The maximum number of points
+     */
+    int maxPoints() const;
+    void setMaxPoints(int newMaxPoints);
+
+    /*!
+     * \brief Returns the type of the curve, switching it keeps the control points
+     * \return The type of the curve
+     */
+    CurveType::Enum curveType() const;
+    void setCurveType(const CurveType::Enum& newCurveType);
+
+    /*!
+     * \brief Returns the seed the next curve is generated with, the one of the current curve until it changes
+     * \return The seed of the control points
+     */
+    quint32 seed() const;
+    void setSeed(quint32 newSeed);
+
   public slots:
     /*!
      * \brief Selects a control point based on provided coordinates
      * \param x The x-coordinate of the point to check
      * \param y The y-coordinate of the point to check
+     * \return A boolean indicating whether a point was hit
+     */
+    bool checkPoints(int x, int y);
+    /*!
+     * \brief Selects all control points inside a rectangle
+     * \param x1 The x-coordinate of one corner
+     * \param y1 The y-coordinate of one corner
+     * \param x2 The x-coordinate of the opposite corner
+     * \param y2 The y-coordinate of the opposite corner
+     */
+    void selectPoints(int x1, int y1, int x2, int y2);
+    /*!
+     * \brief Moves the sprite to the point of the curve closest to provided coordinates
+     * \param x The x-coordinate of the position
+     * \param y The y-coordinate of the position
+     * \param margin The largest distance between the position and the curve, or a negative number for any distance
+     * \return A boolean indicating whether the sprite moved
      */
-    void checkPoints(int x, int y);
+    bool jumpTo(int x, int y, int margin);
     /*!
      * \brief Starts dragging
      */
@@ -76,16 +172,20 @@ class SceneManager : public QObject
      */
     void stopDragging();
     /*!
-     * \brief Moves the selected points to provided coordinates
+     * \brief Moves the selected points, so the grabbed one reaches provided coordinates
      * \param x The x-coordinate of the point to move
      * \param y The y-coordinate of the point to move
      */
     void movePoint(int x, int y);
     /*!
-     * \brief Generates a new Bezier curve
+     * \brief Generates a new curve from the current seed
      * \param count The number of control points for the curve
      */
     void generate(QString count);
+    /*!
+     * \brief Draws a new seed for the next curve
+     */
+    void randomizeSeed();
     /*!
      * \brief Loads an image
      */
@@ -103,12 +203,20 @@ class SceneManager : public QObject
     void isPolylineVisibleChanged();
     void algorithmChanged();
     void animationChanged();
+    void isAtlasEnabledChanged();
+    void atlasBudgetChanged();
+    void targetFpsChanged();
+    void droppedFramesChanged();
+    void curveToleranceChanged();
+    void maxPointsChanged();
+    void curveTypeChanged();
+    void seedChanged();
 
   private:
     /*!
      * \brief The integer validator for the number of points
      */
-    const QIntValidator m_intValidator = QIntValidator(3, 20, this);
+    QIntValidator m_intValidator = QIntValidator(3, 20, this);
     /*!
      * \brief The color for the scene background
      */
@@ -122,50 +230,129 @@ class SceneManager : public QObject
      */
     const QSize m_imageSize = QSize(150, 150);
     /*!
-     * \brief The maximum number of points for the Bezier curve
+     * \brief The upper bound of the maximum number of points, where generating and dragging the spline stay interactive
+     */
+    const int m_pointsLimit = 100000;
+    /*!
+     * \brief The largest number of points of the Bezier curve, every one of them moves the whole curve
+     */
+    const int m_bezierLimit = 1000;
+    /*!
+     * \brief The change of the angle, in radians, below which the previously rotated sprite is reused
      */
-    const int m_maxPoints = 20;
+    const float m_angleTolerance = 0.002f;
     /*!
-     * \brief The running QApplication
+     * \brief The single-shot timer scheduling the next frame
      */
-    QApplication* m_app;
+    QTimer m_timer;
+    /*!
+     * \brief The clock the frame deadlines are measured on
+     */
+    QElapsedTimer m_clock;
+    /*!
+     * \brief The deadline of the next frame in nanoseconds on the clock
+     */
+    qint64 m_deadline;
+    /*!
+     * \brief The frame being painted, swapped with the scene once it is complete
+     */
+    QImage m_back;
+    /*!
+     * \brief The static part of the scene: the background, the curve and the polyline
+     */
+    QImage m_layer;
+    /*!
+     * \brief The area in which the back buffer differs from the layer
+     */
+    QRect m_backSprite;
+    /*!
+     * \brief The area in which the scene differs from the layer
+     */
+    QRect m_sceneSprite;
+    /*!
+     * \brief The area in which the scene differs from the previous one
+     */
+    QRect m_dirtyRect;
     /*!
      * \brief The QPainter for drawing
      */
     QPainter m_painter;
     /*!
-     * \brief The Bezier curve
+     * \brief The curve, either Bezier or spline
      */
-    BezierCurve m_curve;
+    QScopedPointer<Curve> m_curve;
     /*!
      * \brief The circle for rotation
      */
     Circle m_circle;
+    /*!
+     * \brief The cache of rotated sprites
+     */
+    SpriteAtlas m_atlas;
+    /*!
+     * \brief The scratch buffers of the rotations, reused from frame to frame
+     */
+    FrameArena m_arena;
+    /*!
+     * \brief The angle of the sprite held by the arena
+     */
+    float m_spriteTheta;
+    /*!
+     * \brief The part of the sprite held by the arena that the rotation covered
+     */
+    QRect m_spriteRect;
 
     bool m_isDragging;
     bool m_isPlaying;
     bool m_isPolylineVisible;
     bool m_loaded;
+    bool m_isLayerDirty;
+    bool m_isAtlasEnabled;
+    bool m_isSpriteValid;
+    int m_targetFps;
+    int m_maxPoints;
+    int m_droppedFrames;
+    quint32 m_seed;
     Algorithm::Enum m_algorithm;
     Animation::Enum m_animation;
-
+    CurveType::Enum m_curveType;
     /*!
-     * \brief Gets the rectangle for drawing
-     * \param x The x-coordinate of the point
-     * \param y The y-coordinate of the point
-     * \return A QRect representing the rectangle for drawing
+     * \brief The format of the image and of the buffers of the scene, premultiplied outside of the benchmark
      */
-    inline QRect getRect(const int& x, const int& y) const
-    {
-        return QRect(QPoint(x - m_imageSize.width(), y - m_imageSize.height()),
-                     QPoint(x + m_imageSize.width(), y + m_imageSize.height()));
-    }
+    QImage::Format m_format;
+
     /*!
      * \brief Draws the image at given point with a certain rotation angle
-     * \param p The point
+     * \param p The point, between pixels
      * \param theta The angle
+     * \return A QRect representing the pixels covered by the image
+     */
+    QRect draw(const QPointF& p, const float& theta);
+    /*!
+     * \brief Hands the completed back buffer over as the new scene
+     */
+    void present();
+    /*!
+     * \brief Marks the layer to be repainted before the next frame
+     */
+    void invalidateLayer();
+    /*!
+     * \brief Repaints the layer, which makes both buffers dirty in full
+     */
+    void paintLayer();
+    /*!
+     * \brief Copies an area of the layer into the back buffer
+     * \param rect The area to copy
+     */
+    void restore(const QRect& rect);
+    /*!
+     * \brief Refills the sprite atlas for the current image and algorithm, or empties it when disabled
+     */
+    void resetAtlas();
+    /*!
+     * \brief Paints one frame of the animation and schedules the next one
      */
-    void draw(const QPoint& p, const float& theta);
+    void tick();
 
     // new functionality
     QColor HSV2RGB(const float& hue, const float& saturation, const float& value);
@@ -0,0 +1,137 @@
+#include <QtGlobal>
+#include <limits>
+
+#include "SegmentTree.h"
+
+SegmentTree::SegmentTree() : m_segments(0), m_leaves(1) {}
+
+void SegmentTree::build(const QList<QPointF>& points)
+{
+    m_segments = qMax<int>(0, points.count() - 1);
+    m_leaves = 1;
+    while (m_leaves * m_leafSize < m_segments)
+    {
+        m_leaves *= 2;
+    }
+    m_boxes = QList<Box>(2 * m_leaves);
+    for (int leaf = 0; leaf < m_leaves; leaf++)
+    {
+        fitLeaf(points, leaf);
+    }
+    for (int node = m_leaves - 1; node > 0; node--)
+    {
+        fitNode(node);
+    }
+}
+
+void SegmentTree::update(const QList<QPointF>& points, const int& first, const int& last)
+{
+    if (m_segments == 0) { return; }
+    // a point belongs to the segment ending at it and the one starting at it
+    int lo = m_leaves + qMax(0, first - 1) / m_leafSize;
+    int hi = m_leaves + qMin(last, m_segments - 1) / m_leafSize;
+    for (int node = lo; node <= hi; node++)
+    {
+        fitLeaf(points, node - m_leaves);
+    }
+    while (lo > 1)
+    {
+        lo /= 2;
+        hi /= 2;
+        for (int node = lo; node <= hi; node++)
+        {
+            fitNode(node);
+        }
+    }
+}
+
+int SegmentTree::nearest(const QList<QPointF>& points, const QPointF& p, double& fraction) const
+{
+    int best = -1;
+    double bestDistance = std::numeric_limits<double>::max();
+    fraction = 0.0;
+    if (m_segments == 0) { return best; }
+
+    // depth-first, the nearer child first, skipping the boxes farther than the closest segment found so far
+    int stack[64];
+    int top = 0;
+    stack[top++] = 1;
+    while (top > 0)
+    {
+        const int node = stack[--top];
+        if (distance(m_boxes.at(node), p) >= bestDistance) { continue; }
+        if (node >= m_leaves)
+        {
+            const int begin = (node - m_leaves) * m_leafSize;
+            const int end = qMin(begin + m_leafSize, m_segments);
+            for (int i = begin; i < end; i++)
+            {
+                const QPointF a = points.at(i);
+                const QPointF chord = points.at(i + 1) - a;
+                const double squared = QPointF::dotProduct(chord, chord);
+                const double t = squared > 0.0 ? qBound(0.0, QPointF::dotProduct(p - a, chord) / squared, 1.0) : 0.0;
+                const QPointF e = p - a - t * chord;
+                const double d = QPointF::dotProduct(e, e);
+                if (d < bestDistance)
+                {
+                    best = i;
+                    bestDistance = d;
+                    fraction = t;
+                }
+            }
+            continue;
+        }
+        const int left = 2 * node;
+        const int right = left + 1;
+        // the child pushed last is visited first
+        if (distance(m_boxes.at(left), p) <= distance(m_boxes.at(right), p))
+        {
+            stack[top++] = right;
+            stack[top++] = left;
+        }
+        else
+        {
+            stack[top++] = left;
+            stack[top++] = right;
+        }
+    }
+    return best;
+}
+
+void SegmentTree::fitLeaf(const QList<QPointF>& points, const int& leaf)
+{
+    const int begin = leaf * m_leafSize;
+    const int end = qMin(begin + m_leafSize, m_segments);
+    Box& box = m_boxes[m_leaves + leaf];
+    if (begin >= end)
+    {
+        // an empty box, farther than any position
+        box = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+        return;
+    }
+    box = { float(points.at(begin).x()), float(points.at(begin).y()), float(points.at(begin).x()), float(points.at(begin).y()) };
+    for (int i = begin + 1; i <= end; i++)
+    {
+        const QPointF& q = points.at(i);
+        box.minX = qMin(box.minX, float(q.x()));
+        box.minY = qMin(box.minY, float(q.y()));
+        box.maxX = qMax(box.maxX, float(q.x()));
+        box.maxY = qMax(box.maxY, float(q.y()));
+    }
+}
+
+void SegmentTree::fitNode(const int& node)
+{
+    const Box& left = m_boxes.at(2 * node);
+    const Box& right = m_boxes.at(2 * node + 1);
+    m_boxes[node] = { qMin(left.minX, right.minX), qMin(left.minY, right.minY), qMax(left.maxX, right.maxX), qMax(left.maxY, right.maxY) };
+}
+
+double SegmentTree::distance(const Box& box, const QPointF& p)
+{
+    if (box.minX > box.maxX) { return std::numeric_limits<double>::max(); }
+    const double dx = qMax(0.0, qMax(box.minX - p.x(), p.x() - box.maxX));
+    const double dy = qMax(0.0, qMax(box.minY - p.y(), p.y() - box.maxY));
+    return dx * dx + dy * dy;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QList>
+#include <QPointF>
+
+/*!
+ * \brief The SegmentTree class
+ * This class is a bounding volume hierarchy over the segments joining consecutive samples of a curve.
+ * Consecutive segments lie close to each other, so the leaves take runs of them in order and the tree is
+ * a complete binary tree stored in an array, which a change of a few samples updates along their paths to the root.
+ */
+class SegmentTree
+{
+  public:
+    /*!
+     * \brief Constructs an empty SegmentTree object
+     */
+    SegmentTree();
+    /*!
+     * \brief Builds the tree over the segments of a polyline
+     * \param points The points of the polyline
+     */
+    void build(const QList<QPointF>& points);
+    /*!
+     * \brief Updates the boxes after a range of points moved, the number of points has to stay the same
+     * \param points The points of the polyline
+     * \param first The index of the first moved point
+     * \param last The index of the last moved point
+     */
+    void update(const QList<QPointF>& points, const int& first, const int& last);
+    /*!
+     * \brief Finds the segment closest to a position
+     * \param points The points of the polyline
+     * \param p The position
+     * \param fraction The fraction of the way along the segment to the closest point
+     * \return The index of the first point of the segment, or -1 if there is no segment
+     */
+    int nearest(const QList<QPointF>& points, const QPointF& p, double& fraction) const;
+
+  private:
+    /*!
+     * \brief The bounding box of a node
+     */
+    struct Box
+    {
+        float minX;
+        float minY;
+        float maxX;
+        float maxY;
+    };
+    /*!
+     * \brief The number of segments of a leaf
+     */
+    const int m_leafSize = 8;
+    /*!
+     * \brief The number of segments
+     */
+    int m_segments;
+    /*!
+     * \brief The number of leaves, a power of two, the leaves past the last segment stay empty
+     */
+    int m_leaves;
+    /*!
+     * \brief The boxes of the nodes, the root at 1, the children of a node n at 2n and 2n + 1
+     */
+    QList<Box> m_boxes;
+    /*!
+     * \brief Recomputes the box of a leaf from its segments
+     * \param points The points of the polyline
+     * \param leaf The index of the leaf
+     */
+    void fitLeaf(const QList<QPointF>& points, const int& leaf);
+    /*!
+     * \brief Recomputes the box of an inner node from its children
+     * \param node The index of the node
+     */
+    void fitNode(const int& node);
+    /*!
+     * \brief Returns the squared distance from a position to a box
+     * \param box The box
+     * \param p The position
+     * \return The squared distance, zero inside the box
+     */
+    static double distance(const Box& box, const QPointF& p);
+};
@@ -0,0 +1,41 @@
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "Simd.h"
+
+SimdLevel simdLevel()
+{
+    static const SimdLevel level = [] {
+#if defined(BEZIER_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return SimdLevel::SSE2;
+        }
+#elif defined(BEZIER_SIMD_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        const bool sse2 = info[3] & (1 << 26);
+        const bool osxsave = info[2] & (1 << 27);
+        const bool avx = info[2] & (1 << 28);
+        __cpuidex(info, 7, 0);
+        const bool avx2 = info[1] & (1 << 5);
+        // the OS has to save the upper halves of the ymm registers as well
+        if (osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            return SimdLevel::AVX2;
+        }
+        if (sse2)
+        {
+            return SimdLevel::SSE2;
+        }
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
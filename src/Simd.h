@@ -0,0 +1,26 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BEZIER_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if defined(BEZIER_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BEZIER_TARGET_SSE2 __attribute__((target("sse2")))
+#define BEZIER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BEZIER_TARGET_SSE2
+#define BEZIER_TARGET_AVX2
+#endif
+
+/*!
+ * \enum SimdLevel
+ * \brief The enumeration of instruction sets the kernels can be compiled for.
+ */
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+/*!
+ * \brief Returns the widest instruction set supported by the running CPU.
+ * \return The detected instruction set, cached after the first call.
+ */
+SimdLevel simdLevel();
@@ -0,0 +1,238 @@
+#include <algorithm>
+
+#include "SplineCurve.h"
+#include "Executor.h"
+
+SplineCurve::SplineCurve(int count, quint32 seed) : m_samples(0)
+{
+    generate(count, seed);
+}
+
+void SplineCurve::calculateCurve()
+{
+    int minX = m_controlPoints.constFirst().x();
+    int minY = m_controlPoints.constFirst().y();
+    int maxX = minX;
+    int maxY = minY;
+    for (const QPoint& p : m_controlPoints)
+    {
+        minX = qMin(minX, p.x());
+        minY = qMin(minY, p.y());
+        maxX = qMax(maxX, p.x());
+        maxY = qMax(maxY, p.y());
+    }
+    // about a sample every two pixels of the span of the curve, like the Bezier curve, shared by the spans
+    m_samples = qBound(m_minSamples, qMax(maxX - minX, maxY - minY) / (2 * spanCount()), m_maxSamples);
+
+    m_basis = QList<float>(4 * (m_samples + 1));
+    m_derivativeBasis = QList<float>(4 * (m_samples + 1));
+    for (int j = 0; j <= m_samples; j++)
+    {
+        const float u = static_cast<float>(j) / m_samples;
+        const float v = 1.0f - u;
+        float* basis = &m_basis[4 * j];
+        basis[0] = v * v * v / 6.0f;
+        basis[1] = (3.0f * u * u * u - 6.0f * u * u + 4.0f) / 6.0f;
+        basis[2] = (-3.0f * u * u * u + 3.0f * u * u + 3.0f * u + 1.0f) / 6.0f;
+        basis[3] = u * u * u / 6.0f;
+        float* derivativeBasis = &m_derivativeBasis[4 * j];
+        derivativeBasis[0] = -v * v / 2.0f;
+        derivativeBasis[1] = (3.0f * u * u - 4.0f * u) / 2.0f;
+        derivativeBasis[2] = (-3.0f * u * u + 2.0f * u + 1.0f) / 2.0f;
+        derivativeBasis[3] = u * u / 2.0f;
+    }
+
+    m_exact = QList<QPointF>(spanCount() * m_samples + 1);
+    m_angles = QList<float>(m_exact.count());
+    Executor::instance().forRange(m_exact.count(), m_chunk, [this](const int& begin, const int& end) {
+        for (int i = begin; i < end; i++)
+        {
+            evaluateSample(i);
+        }
+    });
+    calculateLengths();
+    m_tree.build(m_exact);
+    flatten();
+}
+
+void SplineCurve::updateCurve(const QList<int>& indices, const QPoint& delta)
+{
+    Q_UNUSED(delta)
+    // a control point is one of the four points of the spans from idx - 2 to idx + 1,
+    // the ranges of the moved points are merged where they overlap or touch
+    QList<QPair<int, int>> ranges;
+    for (const int& idx : indices)
+    {
+        const int first = qMax(0, idx - 2);
+        const int last = qMin(spanCount() - 1, idx + 1);
+        if (!ranges.isEmpty() && first <= ranges.constLast().second + 1)
+        {
+            ranges.last().second = last;
+        }
+        else
+        {
+            ranges.append({ first, last });
+        }
+    }
+    if (ranges.isEmpty()) { return; }
+
+    for (const QPair<int, int>& range : ranges)
+    {
+        const int lastSample = range.second == spanCount() - 1 ? m_exact.count() - 1 : (range.second + 1) * m_samples - 1;
+        for (int i = range.first * m_samples; i <= lastSample; i++)
+        {
+            evaluateSample(i);
+        }
+    }
+    const int lastSpan = ranges.constLast().second;
+    const int firstSample = ranges.constFirst().first * m_samples;
+    const int lastSample = lastSpan == spanCount() - 1 ? m_exact.count() - 1 : (lastSpan + 1) * m_samples - 1;
+    updateLengths(firstSample, lastSample);
+    m_tree.update(m_exact, firstSample, lastSample);
+    if (ranges.count() == 1)
+    {
+        reflatten(ranges.constFirst().first, ranges.constFirst().second);
+    }
+    else
+    {
+        reflatten(ranges);
+    }
+}
+
+void SplineCurve::flatten()
+{
+    m_polyline.clear();
+    m_polyline.append(m_exact.constFirst());
+    m_breaks = QList<int>(spanCount());
+    for (int k = 0; k < spanCount(); k++)
+    {
+        flattenSpan(k, m_polyline);
+        m_breaks[k] = m_polyline.count();
+    }
+}
+
+QPointF SplineCurve::controlPoint(const int& k) const
+{
+    if (k == 0) { return 2 * QPointF(m_controlPoints.at(0)) - QPointF(m_controlPoints.at(1)); }
+    if (k == m_cpCount + 1) { return 2 * QPointF(m_controlPoints.at(m_cpCount - 1)) - QPointF(m_controlPoints.at(m_cpCount - 2)); }
+    return m_controlPoints.at(k - 1);
+}
+
+void SplineCurve::evaluateSample(const int& i)
+{
+    // the end of the last span is its sample past the last row
+    const int k = qMin(i / m_samples, spanCount() - 1);
+    const int j = i - k * m_samples;
+    const float* basis = &m_basis.at(4 * j);
+    const float* derivativeBasis = &m_derivativeBasis.at(4 * j);
+    QPointF p;
+    QPointF tangent;
+    for (int l = 0; l < 4; l++)
+    {
+        const QPointF q = controlPoint(k + l);
+        p += q * basis[l];
+        tangent += q * derivativeBasis[l];
+    }
+    m_exact[i] = p;
+    m_angles[i] = angleOf(tangent);
+}
+
+void SplineCurve::flattenSpan(const int& k, QList<QPointF>& polyline) const
+{
+    // the span as a cubic Bezier curve
+    const QPointF q0 = controlPoint(k);
+    const QPointF q1 = controlPoint(k + 1);
+    const QPointF q2 = controlPoint(k + 2);
+    const QPointF q3 = controlPoint(k + 3);
+    QVarLengthArray<QPointF, 32> points;
+    points.append((q0 + 4 * q1 + q2) / 6);
+    points.append((4 * q1 + 2 * q2) / 6);
+    points.append((2 * q1 + 4 * q2) / 6);
+    points.append((q1 + 4 * q2 + q3) / 6);
+    subdivide(points, 0, polyline);
+}
+
+void SplineCurve::reflatten(const int& first, const int& last)
+{
+    const int begin = first == 0 ? 1 : m_breaks.at(first - 1);
+    const int end = m_breaks.at(last);
+    QList<QPointF> part;
+    for (int k = first; k <= last; k++)
+    {
+        flattenSpan(k, part);
+        m_breaks[k] = begin + part.count();
+    }
+
+    // the tail of the polyline is moved once, by the difference in the number of points
+    const int count = m_polyline.count();
+    const int shift = part.count() - (end - begin);
+    if (shift > 0)
+    {
+        m_polyline.resize(count + shift);
+        std::move_backward(m_polyline.begin() + end, m_polyline.begin() + count, m_polyline.end());
+    }
+    else if (shift < 0)
+    {
+        std::move(m_polyline.begin() + end, m_polyline.end(), m_polyline.begin() + end + shift);
+        m_polyline.resize(count + shift);
+    }
+    std::copy(part.cbegin(), part.cend(), m_polyline.begin() + begin);
+    m_polyline[0] = m_exact.constFirst();
+    for (int k = last + 1; k < spanCount(); k++)
+    {
+        m_breaks[k] += shift;
+    }
+}
+
+void SplineCurve::reflatten(const QList<QPair<int, int>>& ranges)
+{
+    // every patch in place would move the tail of the polyline, so the polyline is rebuilt in one pass,
+    // copying the points of the spans between the ranges
+    QList<QPointF> polyline;
+    polyline.reserve(m_polyline.count());
+    polyline.append(m_exact.constFirst());
+    int from = 1;
+    int k = 0;
+    for (const QPair<int, int>& range : ranges)
+    {
+        const int to = range.first == 0 ? 1 : m_breaks.at(range.first - 1);
+        polyline.append(m_polyline.mid(from, to - from));
+        const int shift = polyline.count() - to;
+        for (; k < range.first; k++)
+        {
+            m_breaks[k] += shift;
+        }
+        from = m_breaks.at(range.second);
+        for (; k <= range.second; k++)
+        {
+            flattenSpan(k, polyline);
+            m_breaks[k] = polyline.count();
+        }
+    }
+    polyline.append(m_polyline.mid(from));
+    const int shift = polyline.count() - m_polyline.count();
+    for (; k < spanCount(); k++)
+    {
+        m_breaks[k] += shift;
+    }
+    m_polyline.swap(polyline);
+}
+
+void SplineCurve::updateLengths(const int& first, const int& last)
+{
+    // the lengths up to the first moved sample stay, the ones past the last moved sample shift by the same amount
+    if (m_lengths.isEmpty()) { return; }
+    const int end = qMin<int>(last + 1, m_lengths.count() - 1);
+    const double before = m_lengths.at(end);
+    for (int i = qMax(1, first); i <= end; i++)
+    {
+        const QPointF d = m_exact.at(i) - m_exact.at(i - 1);
+        m_lengths[i] = m_lengths.at(i - 1) + qSqrt(d.x() * d.x() + d.y() * d.y());
+    }
+    const double shift = m_lengths.at(end) - before;
+    for (int i = end + 1; i < m_lengths.count(); i++)
+    {
+        m_lengths[i] += shift;
+    }
+    m_s = qMin(m_s, m_lengths.constLast());
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Curve.h"
+
+/*!
+ * \brief The SplineCurve class
+ * This class represents a uniform cubic B-spline through the control polygon.
+ * Every span of the spline depends on four consecutive control points only, so dragging a point recomputes
+ * at most four spans, and the curve scales to hundreds of thousands of control points.
+ * The polygon is extended by the reflections of its second and second to last point,
+ * so the spline starts at the first control point and ends at the last one.
+ */
+class SplineCurve : public Curve
+{
+  public:
+    /*!
+     * \brief Constructs a SplineCurve object
+     * \param count The number of control points for the curve
+     * \param seed The seed of the control points
+     */
+    explicit SplineCurve(int count = 3, quint32 seed = 0);
+
+  private:
+    /*!
+     * \brief The smallest number of samples of a span
+     */
+    const int m_minSamples = 4;
+    /*!
+     * \brief The largest number of samples of a span
+     */
+    const int m_maxSamples = 64;
+    /*!
+     * \brief The number of samples evaluated by one chunk of the parallel loop
+     */
+    const int m_chunk = 256;
+    /*!
+     * \brief The number of samples of every span, the end of the last span is sampled as well
+     */
+    int m_samples;
+    /*!
+     * \brief The weights of the four control points of a span at every sample, row-major with four weights per sample
+     */
+    QList<float> m_basis;
+    /*!
+     * \brief The weights of the derivative at every sample, row-major with four weights per sample
+     */
+    QList<float> m_derivativeBasis;
+    /*!
+     * \brief The index in the polyline past the last point of every span
+     */
+    QList<int> m_breaks;
+    /*!
+     * \brief Calculates the spline
+     */
+    void calculateCurve() override;
+    /*!
+     * \brief Recomputes the spans around the control points that moved
+     * \param indices The indices of the moved control points in ascending order
+     * \param delta The displacement of the control points
+     */
+    void updateCurve(const QList<int>& indices, const QPoint& delta) override;
+    /*!
+     * \brief Flattens the curve into the painted polyline
+     */
+    void flatten() override;
+    /*!
+     * \brief Returns the number of spans of the spline
+     * \return An integer representing the number of spans
+     */
+    inline int spanCount() const
+    {
+        return m_cpCount - 1;
+    }
+    /*!
+     * \brief Returns a point of the extended control polygon
+     * \param k The index in the extended polygon, from 0 to m_cpCount + 1
+     * \return The control point, or the reflection of its neighbour at both ends
+     */
+    QPointF controlPoint(const int& k) const;
+    /*!
+     * \brief Evaluates the point and the angle of the tangent of a sample
+     * \param i The index of the sample
+     */
+    void evaluateSample(const int& i);
+    /*!
+     * \brief Appends the flattened span to a polyline, the start of the span is already there
+     * \param k The index of the span
+     * \param polyline The polyline
+     */
+    void flattenSpan(const int& k, QList<QPointF>& polyline) const;
+    /*!
+     * \brief Replaces a range of spans in the painted polyline with their flattened form
+     * \param first The index of the first span
+     * \param last The index of the last span
+     */
+    void reflatten(const int& first, const int& last);
+    /*!
+     * \brief Replaces several ranges of spans in the painted polyline with their flattened form
+     * \param ranges The first and the last span of every range, in ascending order
+     */
+    void reflatten(const QList<QPair<int, int>>& ranges);
+    /*!
+     * \brief Updates the arc length table after a range of samples moved
+     * \param first The index of the first moved sample
+     * \param last The index of the last moved sample
+     */
+    void updateLengths(const int& first, const int& last);
+};
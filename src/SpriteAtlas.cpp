@@ -0,0 +1,116 @@
+#include <QtConcurrent/QtConcurrent>
+#include <QtMath>
+
+#include "SpriteAtlas.h"
+#include "Algorithms.h"
+
+SpriteAtlas::SpriteAtlas(qsizetype budget) : m_sprites(budget), m_algorithm(Algorithm::Enum::Naive), m_generation(0) {}
+
+SpriteAtlas::~SpriteAtlas()
+{
+    clear();
+}
+
+qsizetype SpriteAtlas::budget() const
+{
+    return m_sprites.maxCost();
+}
+
+void SpriteAtlas::setBudget(qsizetype budget)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sprites.setMaxCost(budget);
+}
+
+void SpriteAtlas::reset(const QSharedPointer<QImage>& image, const Algorithm::Enum& algorithm)
+{
+    clear();
+    QMutexLocker locker(&m_mutex);
+    // the caller keeps drawing into its image, so the atlas works on its own shallow copy
+    m_image = QSharedPointer<QImage>::create(*image);
+    m_algorithm = algorithm;
+}
+
+void SpriteAtlas::clear()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_generation++;
+        m_sprites.clear();
+    }
+    // the build notices the new generation after its current sprite, so this waits for one rotation at most
+    m_build.waitForFinished();
+}
+
+void SpriteAtlas::prerender(const QList<float>& angles)
+{
+    m_build.waitForFinished();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_image.isNull()) { return; }
+    const QSharedPointer<QImage> image = m_image;
+    const Algorithm::Enum algorithm = m_algorithm;
+    const quint64 generation = m_generation;
+    locker.unlock();
+
+    m_build = QtConcurrent::run([this, angles, image, algorithm, generation]() {
+        FrameArena arena;
+        for (const float& theta : angles)
+        {
+            {
+                QMutexLocker locker(&m_mutex);
+                if (m_generation != generation) { return; }
+                if (m_sprites.contains(key(theta))) { continue; }
+            }
+            QImage* sprite = new QImage(rotate(image, algorithm, theta, arena));
+            QMutexLocker locker(&m_mutex);
+            if (m_generation != generation)
+            {
+                delete sprite;
+                return;
+            }
+            m_sprites.insert(key(theta), sprite, sprite->sizeInBytes());
+        }
+    });
+}
+
+QImage SpriteAtlas::sprite(const float& theta)
+{
+    QMutexLocker locker(&m_mutex);
+    if (const QImage* cached = m_sprites.object(key(theta)))
+    {
+        return *cached;
+    }
+    if (m_image.isNull()) { return QImage(); }
+    const QSharedPointer<QImage> image = m_image;
+    const Algorithm::Enum algorithm = m_algorithm;
+    const quint64 generation = m_generation;
+    locker.unlock();
+
+    FrameArena arena;
+    QImage sprite = rotate(image, algorithm, theta, arena);
+
+    locker.relock();
+    if (m_generation == generation)
+    {
+        m_sprites.insert(key(theta), new QImage(sprite), sprite.sizeInBytes());
+    }
+    return sprite;
+}
+
+int SpriteAtlas::key(const float& theta)
+{
+    const int k = qRound(theta * m_resolution / (2 * M_PI)) % m_resolution;
+    return k < 0 ? k + m_resolution : k;
+}
+
+QImage SpriteAtlas::rotate(const QSharedPointer<QImage>& image, const Algorithm::Enum& algorithm, const float& theta, FrameArena& arena)
+{
+    QImage& dest = arena.image(FrameArena::Image::Sprite, 2 * image->size(), QImage::Format_ARGB32_Premultiplied);
+    const QRect rect = Rotate(dest, image, algorithm, theta, image->width() / 2, arena);
+    if (rect.isEmpty()) { return QImage(); }
+    // only the covered part is kept, the offset places it within the full sprite
+    QImage sprite = dest.copy(rect);
+    sprite.setOffset(rect.topLeft());
+    return sprite;
+}
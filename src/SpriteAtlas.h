@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QCache>
+#include <QFuture>
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include "Enums.h"
+#include "FrameArena.h"
+
+/*!
+ * \brief The SpriteAtlas class
+ * This class caches rotated copies of the sprite, keyed by the rotation angle.
+ * The angles of a known track (like the Circle) can be prerendered in the background,
+ * any other angle is rotated on first use. The least recently used sprites are evicted
+ * once the memory budget is exceeded.
+ */
+class SpriteAtlas
+{
+  public:
+    /*!
+     * \brief Constructs a SpriteAtlas object
+     * \param budget The memory budget in bytes
+     */
+    explicit SpriteAtlas(qsizetype budget = 64 * 1024 * 1024);
+    /*!
+     * \brief Destroys the SpriteAtlas object, waiting for the background build to stop
+     */
+    ~SpriteAtlas();
+    /*!
+     * \brief Returns the memory budget
+     * \return The memory budget in bytes
+     */
+    qsizetype budget() const;
+    /*!
+     * \brief Sets the memory budget, evicting the least recently used sprites if needed
+     * \param budget The memory budget in bytes
+     */
+    void setBudget(qsizetype budget);
+    /*!
+     * \brief Drops all sprites and sets the image and algorithm used for the new ones
+     * \param image The image to rotate, a shallow copy of it is kept
+     * \param algorithm The rotation algorithm
+     */
+    void reset(const QSharedPointer<QImage>& image, const Algorithm::Enum& algorithm);
+    /*!
+     * \brief Drops all sprites and stops the background build
+     */
+    void clear();
+    /*!
+     * \brief Rotates the sprite for every given angle in the background
+     * \param angles The angles in radians
+     */
+    void prerender(const QList<float>& angles);
+    /*!
+     * \brief Returns the sprite rotated by the given angle, rotating it now if it is not cached
+     * \param theta The rotation angle in radians
+     * \return The part of the rotated sprite the image covers, its offset places it within a sprite twice the size of the image
+     */
+    QImage sprite(const float& theta);
+
+  private:
+    /*!
+     * \brief The number of keys per full turn, angles closer than that share a sprite
+     */
+    static constexpr int m_resolution = 3600;
+    /*!
+     * \brief Guards the cache, the image and the generation
+     */
+    QMutex m_mutex;
+    /*!
+     * \brief The rotated sprites, with their size in bytes as the cost
+     */
+    QCache<int, QImage> m_sprites;
+    /*!
+     * \brief The image to rotate
+     */
+    QSharedPointer<QImage> m_image;
+    /*!
+     * \brief The rotation algorithm
+     */
+    Algorithm::Enum m_algorithm;
+    /*!
+     * \brief The counter bumped on every reset, so stale background work is discarded
+     */
+    quint64 m_generation;
+    /*!
+     * \brief The running background build
+     */
+    QFuture<void> m_build;
+    /*!
+     * \brief Returns the cache key of an angle
+     * \param theta The angle in radians
+     * \return The angle quantized to the atlas resolution
+     */
+    static int key(const float& theta);
+    /*!
+     * \brief Rotates the image
+     * \param image The image to rotate
+     * \param algorithm The rotation algorithm
+     * \param theta The rotation angle in radians
+     * \param arena The arena providing the scratch buffers
+     * \return The part of the rotated sprite the image covers, with its offset within the full sprite
+     */
+    static QImage rotate(const QSharedPointer<QImage>& image, const Algorithm::Enum& algorithm, const float& theta, FrameArena& arena);
+};
@@ -0,0 +1,77 @@
+#include <rhi/qrhi.h>
+
+#include "TileTexture.h"
+
+TileTexture::TileTexture(const QRect& tile, const bool& hasAlpha) : m_texture(nullptr), m_tile(tile), m_hasAlpha(hasAlpha) {}
+
+TileTexture::~TileTexture()
+{
+    delete m_texture;
+}
+
+bool TileTexture::setSource(const QImage& frame, const QRect& rect)
+{
+    // a texture not created yet needs all of its tile
+    const QRect changed = (m_texture ? rect : m_tile) & m_tile;
+    if (changed.isEmpty()) { return false; }
+    m_frame = frame;
+    m_pending |= changed;
+    return true;
+}
+
+qint64 TileTexture::comparisonKey() const
+{
+    return qint64(qintptr(this));
+}
+
+QRhiTexture* TileTexture::rhiTexture() const
+{
+    return m_texture;
+}
+
+QSize TileTexture::textureSize() const
+{
+    return m_tile.size();
+}
+
+bool TileTexture::hasAlphaChannel() const
+{
+    return m_hasAlpha;
+}
+
+bool TileTexture::hasMipmaps() const
+{
+    return false;
+}
+
+void TileTexture::commitTextureOperations(QRhi* rhi, QRhiResourceUpdateBatch* resourceUpdates)
+{
+    if (m_pending.isEmpty()) { return; }
+    if (!m_texture)
+    {
+        m_texture = rhi->newTexture(rhi->isTextureFormatSupported(QRhiTexture::BGRA8) ? QRhiTexture::BGRA8 : QRhiTexture::RGBA8,
+                                    m_tile.size());
+        m_texture->create();
+    }
+
+    // a premultiplied frame already holds its bytes in the order of a BGRA texture, other frames are converted
+    const QImage::Format format = m_texture->format() == QRhiTexture::BGRA8 ? QImage::Format_ARGB32_Premultiplied
+                                                                             : QImage::Format_RGBA8888_Premultiplied;
+    QRhiTextureSubresourceUploadDescription description;
+    if (m_frame.format() == format || (format == QImage::Format_ARGB32_Premultiplied && m_frame.format() == QImage::Format_RGB32))
+    {
+        description = QRhiTextureSubresourceUploadDescription(m_frame);
+        description.setSourceTopLeft(m_pending.topLeft());
+    }
+    else
+    {
+        description = QRhiTextureSubresourceUploadDescription(m_frame.copy(m_pending).convertToFormat(format));
+    }
+    description.setSourceSize(m_pending.size());
+    description.setDestinationTopLeft(m_pending.topLeft() - m_tile.topLeft());
+    resourceUpdates->uploadTexture(m_texture, QRhiTextureUploadEntry(0, 0, description));
+
+    // the batch holds the frame until the upload is done, the texture lets go of it now
+    m_frame = QImage();
+    m_pending = QRect();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QImage>
+#include <QSGTexture>
+
+/*!
+ * \brief The TileTexture class
+ * This class is the texture of one tile of a frame shown by a SceneItem.
+ * The texture is created once and the changed part of the tile is uploaded into it straight
+ * from the frame, without copying the pixels into an image of their own first.
+ */
+class TileTexture : public QSGTexture
+{
+  public:
+    /*!
+     * \brief Constructs a TileTexture object
+     * \param tile The area of the frame covered by the texture
+     * \param hasAlpha Whether the frame has an alpha channel to blend with
+     */
+    TileTexture(const QRect& tile, const bool& hasAlpha);
+    ~TileTexture() override;
+    /*!
+     * \brief Schedules an upload of the changed part of the tile for the next frame
+     * \param frame The frame the tile is taken from, held until the upload
+     * \param rect The changed area of the frame
+     * \return True if the tile is touched by the changed area
+     */
+    bool setSource(const QImage& frame, const QRect& rect);
+
+    qint64 comparisonKey() const override;
+    QRhiTexture* rhiTexture() const override;
+    QSize textureSize() const override;
+    bool hasAlphaChannel() const override;
+    bool hasMipmaps() const override;
+    /*!
+     * \brief Creates the texture on first use and records the pending upload
+     * \param rhi The rendering hardware interface of the window
+     * \param resourceUpdates The batch the upload is recorded in
+     */
+    void commitTextureOperations(QRhi* rhi, QRhiResourceUpdateBatch* resourceUpdates) override;
+
+  private:
+    /*!
+     * \brief The texture, null until the first upload
+     */
+    QRhiTexture* m_texture;
+    /*!
+     * \brief The area of the frame covered by the texture
+     */
+    QRect m_tile;
+    /*!
+     * \brief Whether the frame has an alpha channel to blend with
+     */
+    bool m_hasAlpha;
+    /*!
+     * \brief The frame to upload from, a shallow copy released once the upload is recorded
+     */
+    QImage m_frame;
+    /*!
+     * \brief The area of the frame still to be uploaded
+     */
+    QRect m_pending;
+};
@@ -0,0 +1,37 @@
+QT += core gui
+CONFIG += c++20 console
+CONFIG -= app_bundle
+
+TARGET = Bezier-Spinning-Batch
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        ../Algorithms.cpp \
+        ../Bernstein.cpp \
+        ../BezierCurve.cpp \
+        ../Circle.cpp \
+        ../Curve.cpp \
+        ../Executor.cpp \
+        ../FrameArena.cpp \
+        ../PointGrid.cpp \
+        ../RandomStream.cpp \
+        ../SegmentTree.cpp \
+        ../Simd.cpp \
+        ../SplineCurve.cpp \
+        main.cpp
+
+HEADERS += \
+    ../Algorithms.h \
+    ../Bernstein.h \
+    ../BezierCurve.h \
+    ../Circle.h \
+    ../Curve.h \
+    ../Enums.h \
+    ../Executor.h \
+    ../FrameArena.h \
+    ../PointGrid.h \
+    ../RandomStream.h \
+    ../SegmentTree.h \
+    ../Simd.h \
+    ../SplineCurve.h
@@ -0,0 +1,269 @@
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QHash>
+#include <QPainter>
+#include <QThread>
+#include <cstring>
+
+#include "Algorithms.h"
+#include "BezierCurve.h"
+#include "Circle.h"
+#include "Executor.h"
+#include "FrameArena.h"
+#include "SplineCurve.h"
+
+namespace
+{
+/*!
+ * \brief The size of the scene, the same as in the application
+ */
+const QSize SceneSize = QSize(800, 800);
+/*!
+ * \brief The size the image is scaled to, the same as in the application
+ */
+const QSize ImageSize = QSize(150, 150);
+/*!
+ * \brief The position and the rotation of the sprite in one frame
+ */
+struct FrameState
+{
+    QPointF position;
+    float theta;
+};
+
+/*!
+ * \brief The buffers of one frame being rendered, reused by the following batches
+ */
+struct FrameSlot
+{
+    int index;
+    FrameState state;
+    QImage frame;
+    QImage raw;
+    FrameArena arena;
+    bool saved;
+};
+
+/*!
+ * \brief Parses control points given as "x1,y1;x2,y2;...".
+ * \param text The list of points.
+ * \return The points, or an empty list if any of them is invalid.
+ */
+QList<QPoint> parsePoints(const QString& text)
+{
+    QList<QPoint> points;
+    for (const QString& pair : text.split(';', Qt::SkipEmptyParts))
+    {
+        const QStringList coordinates = pair.split(',');
+        bool okX = false;
+        bool okY = false;
+        const int x = coordinates.value(0).trimmed().toInt(&okX);
+        const int y = coordinates.value(1).trimmed().toInt(&okY);
+        if (coordinates.count() != 2 || !okX || !okY) { return QList<QPoint>(); }
+        points.append(QPoint(x, y));
+    }
+    return points;
+}
+
+/*!
+ * \brief Renders one frame into its slot, the same way SceneManager paints it.
+ * \param slot The slot holding the state and the buffers of the frame.
+ * \param layer The static part of the scene.
+ * \param image The image to rotate.
+ * \param algorithm The rotation algorithm.
+ */
+void renderFrame(FrameSlot& slot, const QImage& layer, const QSharedPointer<QImage>& image, const Algorithm::Enum& algorithm)
+{
+    std::memcpy(slot.frame.bits(), layer.constBits(), layer.sizeInBytes());
+
+    QImage& sprite = slot.arena.image(FrameArena::Image::Sprite, 2 * ImageSize, QImage::Format_ARGB32_Premultiplied);
+    const QRect rect = Rotate(sprite, image, algorithm, slot.state.theta, ImageSize.width() / 2, slot.arena);
+
+    const QPointF& p = slot.state.position;
+    QPainter painter(&slot.frame);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter.drawImage(QPointF(p.x() - ImageSize.width(), p.y() - ImageSize.height()) + rect.topLeft(), sprite, rect);
+    painter.end();
+}
+}
+
+int main(int argc, char *argv[]) {
+    // frames are only rendered into images, no window is ever shown
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Bezier-Spinning-Batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders frames of the animation without the user interface. "
+                                     "Raw frames are 800x800 RGBA8888 images written one after another.");
+    parser.addHelpOption();
+    const QCommandLineOption pointsOption("points", "Control points as \"x1,y1;x2,y2;...\".", "list");
+    const QCommandLineOption seedOption("seed", "Seed of the random control points.", "seed", "0");
+    const QCommandLineOption countOption("count", "Number of random control points.", "count", "5");
+    const QCommandLineOption imageOption("image", "Image to rotate.", "file");
+    const QCommandLineOption algorithmOption("algorithm", "Rotation algorithm: naive, bilinear, bicubic or shear.", "name", "naive");
+    const QCommandLineOption animationOption("animation", "Animation: rotation or moving.", "name", "rotation");
+    const QCommandLineOption curveOption("curve", "Curve: bezier or spline.", "name", "bezier");
+    const QCommandLineOption framesOption("frames", "Number of frames.", "count", "120");
+    const QCommandLineOption outputOption({ "o", "output" }, "Directory of the PNG sequence.", "directory", ".");
+    const QCommandLineOption rawOption("raw", "Write raw RGBA frames to the standard output instead of PNG files.");
+    const QCommandLineOption polylineOption("polyline", "Draw the polyline of the control points.");
+    const QCommandLineOption threadsOption("threads", "Number of threads.", "count", QString::number(QThread::idealThreadCount()));
+    parser.addOptions({ pointsOption, seedOption, countOption, imageOption, algorithmOption, animationOption,
+                        curveOption, framesOption, outputOption, rawOption, polylineOption, threadsOption });
+    parser.process(app);
+    Executor::instance().setThreadCount(qMax(1, parser.value(threadsOption).toInt()));
+
+    QList<QPoint> points;
+    if (parser.isSet(pointsOption))
+    {
+        points = parsePoints(parser.value(pointsOption));
+    }
+    else
+    {
+        points = Curve::randomPoints(qMax(0, parser.value(countOption).toInt()), SceneSize, parser.value(seedOption).toUInt());
+    }
+    if (points.count() < 3)
+    {
+        qCritical("The curve needs at least 3 valid control points.");
+        return 1;
+    }
+
+    QSharedPointer<QImage> image(new QImage());
+    if (!parser.isSet(imageOption) || !image->load(parser.value(imageOption)))
+    {
+        qCritical("Cannot load the image, pass it with --image.");
+        return 1;
+    }
+    *image = image->scaled(ImageSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    // premultiplied like in the application, the format the rotations and the painter work in
+    image->convertTo(QImage::Format_ARGB32_Premultiplied);
+
+    const QString algorithmName = parser.value(algorithmOption).toLower();
+    const QString animationName = parser.value(animationOption).toLower();
+    const QString curveName = parser.value(curveOption).toLower();
+    const QHash<QString, Algorithm::Enum> algorithms { { "naive", Algorithm::Enum::Naive }, { "bilinear", Algorithm::Enum::Bilinear },
+                                                       { "bicubic", Algorithm::Enum::Bicubic }, { "shear", Algorithm::Enum::Shear } };
+    if (!algorithms.contains(algorithmName) || (animationName != "rotation" && animationName != "moving")
+        || (curveName != "bezier" && curveName != "spline"))
+    {
+        qCritical("Unknown algorithm, animation or curve.");
+        return 1;
+    }
+    const Algorithm::Enum algorithm = algorithms.value(algorithmName);
+    const Animation::Enum animation = animationName == "rotation" ? Animation::Enum::Rotation : Animation::Enum::Moving;
+    const int frames = qMax(0, parser.value(framesOption).toInt());
+    const bool isRaw = parser.isSet(rawOption);
+    const QDir directory(parser.value(outputOption));
+    if (!isRaw && !directory.mkpath("."))
+    {
+        qCritical("Cannot create the output directory.");
+        return 1;
+    }
+
+    QScopedPointer<Curve> curve;
+    if (curveName == "bezier")
+    {
+        curve.reset(new BezierCurve());
+    }
+    else
+    {
+        curve.reset(new SplineCurve());
+    }
+    curve->setControlPoints(points);
+    Circle circle;
+
+    QImage layer(SceneSize, QImage::Format_ARGB32_Premultiplied);
+    layer.fill(QColor(255, 255, 255));
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    curve->paint(painter, parser.isSet(polylineOption));
+    painter.end();
+
+    // stepping the animation is cheap, so every frame's state is known before any of them is rendered
+    QList<FrameState> states(frames);
+    for (FrameState& state : states)
+    {
+        if (animation == Animation::Enum::Rotation)
+        {
+            state.theta = circle.next();
+            state.position = curve->current();
+        }
+        else
+        {
+            state.position = curve->next();
+            state.theta = curve->currentAngle();
+        }
+    }
+
+    QFile output;
+    if (isRaw && !output.open(stdout, QIODevice::WriteOnly))
+    {
+        qCritical("Cannot write to the standard output.");
+        return 1;
+    }
+
+    // the frames are rendered in batches of one per thread, the slots keep their buffers between batches,
+    // the rotations inside a frame find the executor busy and run on the thread of their frame
+    QList<FrameSlot> batch(Executor::instance().threadCount());
+    for (FrameSlot& slot : batch)
+    {
+        slot.frame = QImage(SceneSize, QImage::Format_ARGB32_Premultiplied);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    bool isSaved = true;
+    for (int first = 0; first < frames && isSaved; first += batch.count())
+    {
+        const int count = qMin<int>(batch.count(), frames - first);
+        for (int i = 0; i < count; i++)
+        {
+            batch[i].index = first + i;
+            batch[i].state = states.at(first + i);
+        }
+        Executor::instance().forRange(count, 1, [&](const int& begin, const int& end) {
+            for (int i = begin; i < end; i++)
+            {
+                FrameSlot& slot = batch[i];
+                renderFrame(slot, layer, image, algorithm);
+                if (isRaw)
+                {
+                    slot.raw = slot.frame.convertToFormat(QImage::Format_RGBA8888);
+                    slot.saved = true;
+                }
+                else
+                {
+                    slot.saved = slot.frame.save(directory.filePath(QString("frame_%1.png").arg(slot.index, 5, 10, QChar('0'))));
+                }
+            }
+        });
+        for (int i = 0; i < count; i++)
+        {
+            FrameSlot& slot = batch[i];
+            if (isRaw)
+            {
+                // the rows of a 800 pixels wide image are never padded, the frame is one block
+                slot.saved = output.write(reinterpret_cast<const char*>(slot.raw.constBits()), slot.raw.sizeInBytes()) == slot.raw.sizeInBytes();
+            }
+            isSaved = isSaved && slot.saved;
+        }
+    }
+    output.close();
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    if (!isSaved)
+    {
+        qCritical("Cannot write the frames.");
+        return 1;
+    }
+    qInfo("Rendered %d frames in %.3f s, %.1f frames per second.", frames, elapsed / 1e9, elapsed > 0 ? frames * 1e9 / elapsed : 0.0);
+    return 0;
+}
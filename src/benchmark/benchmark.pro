@@ -0,0 +1,41 @@
+QT += core gui widgets concurrent
+CONFIG += c++20 console
+CONFIG -= app_bundle
+
+TARGET = Bezier-Spinning-Benchmark
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        ../Algorithms.cpp \
+        ../Bernstein.cpp \
+        ../BezierCurve.cpp \
+        ../Circle.cpp \
+        ../Curve.cpp \
+        ../Executor.cpp \
+        ../FrameArena.cpp \
+        ../PointGrid.cpp \
+        ../RandomStream.cpp \
+        ../SceneManager.cpp \
+        ../SegmentTree.cpp \
+        ../Simd.cpp \
+        ../SplineCurve.cpp \
+        ../SpriteAtlas.cpp \
+        main.cpp
+
+HEADERS += \
+    ../Algorithms.h \
+    ../Bernstein.h \
+    ../BezierCurve.h \
+    ../Circle.h \
+    ../Curve.h \
+    ../Enums.h \
+    ../Executor.h \
+    ../FrameArena.h \
+    ../PointGrid.h \
+    ../RandomStream.h \
+    ../SceneManager.h \
+    ../SegmentTree.h \
+    ../Simd.h \
+    ../SplineCurve.h \
+    ../SpriteAtlas.h
@@ -0,0 +1,399 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <numeric>
+
+#include "Algorithms.h"
+#include "BezierCurve.h"
+#include "Executor.h"
+#include "SceneManager.h"
+#include "Simd.h"
+#include "SplineCurve.h"
+
+namespace
+{
+/*!
+ * \brief The number of calls to operator new so far, on any thread
+ */
+std::atomic<qint64> heapAllocations(0);
+}
+
+// every allocation through operator new is counted, the arrays and the nothrow variants end up here as well,
+// Qt's containers and images allocate with malloc and are left out
+void* operator new(std::size_t size)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) { return p; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t size) noexcept
+{
+    Q_UNUSED(size)
+    std::free(p);
+}
+
+namespace
+{
+/*!
+ * \brief The settings shared by all measurements
+ */
+struct Options
+{
+    qint64 minTime;
+    int minIterations;
+    quint32 seed;
+};
+
+/*!
+ * \brief Runs a function repeatedly and summarizes the time of one call.
+ * \param name The name of the measured operation.
+ * \param options The minimal time and number of calls.
+ * \param function The function to measure.
+ * \return A JSON object with the name, the number of calls and their minimal, median and mean time in nanoseconds.
+ */
+QJsonObject measure(const QString& name, const Options& options, const std::function<void()>& function)
+{
+    // the first call fills the caches and the pooled buffers
+    function();
+
+    QList<qint64> samples;
+    QElapsedTimer total;
+    total.start();
+    while (samples.count() < options.minIterations || total.elapsed() < options.minTime)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        function();
+        samples.append(timer.nsecsElapsed());
+    }
+    std::sort(samples.begin(), samples.end());
+    const qint64 sum = std::accumulate(samples.cbegin(), samples.cend(), qint64(0));
+
+    QJsonObject result;
+    result["name"] = name;
+    result["iterations"] = samples.count();
+    result["minNs"] = double(samples.constFirst());
+    result["medianNs"] = double(samples.at(samples.count() / 2));
+    result["meanNs"] = double(sum) / samples.count();
+    return result;
+}
+
+/*!
+ * \brief Creates a square test image with a color gradient and a transparent corner.
+ * \param size The side of the image.
+ * \return The image in Format_ARGB32_Premultiplied, like the loaded images of the application.
+ */
+QSharedPointer<QImage> testImage(const int& size)
+{
+    QSharedPointer<QImage> image(new QImage(size, size, QImage::Format_ARGB32));
+    for (int y = 0; y < size; y++)
+    {
+        QRgb* row = reinterpret_cast<QRgb*>(image->scanLine(y));
+        for (int x = 0; x < size; x++)
+        {
+            const int alpha = x + y < size / 4 ? 0 : 255;
+            row[x] = qRgba(255 * x / size, 255 * y / size, 255 * (x + y) / (2 * size), alpha);
+        }
+    }
+    image->convertTo(QImage::Format_ARGB32_Premultiplied);
+    return image;
+}
+
+/*!
+ * \brief Parses a comma-separated list of integers.
+ * \param text The list.
+ * \return The integers, the invalid entries are skipped.
+ */
+QList<int> parseList(const QString& text)
+{
+    QList<int> values;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts))
+    {
+        bool ok = false;
+        const int value = part.trimmed().toInt(&ok);
+        if (ok && value > 0)
+        {
+            values.append(value);
+        }
+    }
+    return values;
+}
+
+/*!
+ * \brief Measures the rotation kernels for one sprite size.
+ * \param results The array the results are appended to.
+ * \param options The measurement settings.
+ * \param size The side of the sprite.
+ * \param threads The number of threads of the pool.
+ */
+void benchmarkKernels(QJsonArray& results, const Options& options, const int& size, const int& threads)
+{
+    const QSharedPointer<QImage> sour = testImage(size);
+    const QSize destSize = 2 * sour->size();
+    const int offset = size / 2;
+    // past a quarter turn, so the triple shear also runs a quarter turn first
+    const float theta = 2.0f;
+    FrameArena arena;
+
+    const auto add = [&results, &size, &threads](QJsonObject result) {
+        result["size"] = size;
+        result["threads"] = threads;
+        results.append(result);
+    };
+
+    add(measure("Sour2Dest", options, [&]() {
+        Sour2Dest(arena.image(FrameArena::Image::Temp, destSize, QImage::Format_ARGB32_Premultiplied), *sour, offset);
+    }));
+    add(measure("Naive", options, [&]() {
+        Naive(arena.image(FrameArena::Image::Sprite, destSize, QImage::Format_ARGB32_Premultiplied), sour, theta, offset, arena);
+    }));
+    add(measure("Bilinear", options, [&]() {
+        Bilinear(arena.image(FrameArena::Image::Sprite, destSize, QImage::Format_ARGB32_Premultiplied), sour, theta, offset, arena);
+    }));
+    add(measure("Bicubic", options, [&]() {
+        Bicubic(arena.image(FrameArena::Image::Sprite, destSize, QImage::Format_ARGB32_Premultiplied), sour, theta, offset, arena);
+    }));
+    add(measure("Shear", options, [&]() {
+        Shear(arena.image(FrameArena::Image::Sprite, destSize, QImage::Format_ARGB32_Premultiplied), sour, theta, offset, arena);
+    }));
+
+    // the quarter turns get buffers of their own, the arena slots are their scratch space inside Shear
+    QImage turnSour(destSize, QImage::Format_ARGB32_Premultiplied);
+    QImage turnDest(destSize, QImage::Format_ARGB32_Premultiplied);
+    Sour2Dest(turnSour, *sour, offset);
+    add(measure("TurnImage_90", options, [&]() { TurnImage_90(turnDest, turnSour); }));
+    add(measure("TurnImage_180", options, [&]() { TurnImage_180(turnDest, turnSour); }));
+    add(measure("TurnImage_270", options, [&]() { TurnImage_270(turnDest, turnSour); }));
+
+    // compositing a sprite the way SceneManager::draw does, from the straight-alpha format the pipeline
+    // used before and from the premultiplied one it uses now
+    for (const QImage::Format& format : { QImage::Format_ARGB32, QImage::Format_ARGB32_Premultiplied })
+    {
+        QImage frame(destSize, format);
+        frame.fill(Qt::white);
+        const QImage sprite = turnSour.convertToFormat(format);
+        QJsonObject result = measure("drawImage", options, [&frame, &sprite]() {
+            QPainter painter(&frame);
+            painter.setRenderHint(QPainter::Antialiasing, true);
+            painter.drawImage(QPoint(0, 0), sprite);
+        });
+        result["format"] = format == QImage::Format_ARGB32 ? "ARGB32" : "ARGB32_Premultiplied";
+        add(result);
+    }
+}
+
+/*!
+ * \brief Measures the curve evaluation for one number of control points.
+ * \param results The array the results are appended to.
+ * \param options The measurement settings.
+ * \param curve The curve, generated again with the number of points and evaluated again from them.
+ * \param name The name of the class of the curve.
+ * \param points The number of control points.
+ * \param threads The number of threads of the pool.
+ */
+void benchmarkCurve(QJsonArray& results, const Options& options, Curve& curve, const QString& name, const int& points, const int& threads)
+{
+    const auto add = [&results, &points, &threads](QJsonObject result) {
+        result["points"] = points;
+        result["threads"] = threads;
+        results.append(result);
+    };
+
+    // the control points are drawn once, so only the evaluation of the same curve is timed
+    curve.generate(points, options.seed);
+    const QList<QPoint> controlPoints = curve.controlPoints();
+    add(measure(name + "::calculateCurve", options, [&]() { curve.setControlPoints(controlPoints); }));
+
+    const QPoint first = curve.first();
+    curve.select(first.x(), first.y());
+    int step = 0;
+    add(measure(name + "::drag", options, [&]() {
+        // one pixel back and forth, which the incremental update handles
+        curve.drag(first.x() + (step++ % 2), first.y());
+    }));
+
+    add(measure(name + "::currentAngle", options, [&]() {
+        curve.next();
+        volatile float angle = curve.currentAngle();
+        Q_UNUSED(angle)
+    }));
+}
+
+/*!
+ * \brief Measures the painting of whole frames.
+ * \param results The array the results are appended to.
+ * \param options The measurement settings.
+ * \param threads The number of threads of the pool.
+ */
+void benchmarkPaint(QJsonArray& results, const Options& options, const int& threads)
+{
+    SceneManager manager(options.seed);
+    manager.create();
+    // the frame timer never fires without an event loop, paint() is driven directly
+    manager.setIsPlaying(true);
+
+    const QList<QPair<Algorithm::Enum, QString>> algorithms { { Algorithm::Enum::Naive, "Naive" }, { Algorithm::Enum::Bilinear, "Bilinear" },
+                                                              { Algorithm::Enum::Bicubic, "Bicubic" }, { Algorithm::Enum::Shear, "Shear" } };
+    // whole frames in the straight-alpha format the pipeline used before and in the premultiplied one it uses now
+    for (const QImage::Format& format : { QImage::Format_ARGB32, QImage::Format_ARGB32_Premultiplied })
+    {
+        manager.setPixelFormat(format);
+        for (const auto& [algorithm, name] : algorithms)
+        {
+            for (const Animation::Enum& animation : { Animation::Enum::Rotation, Animation::Enum::Moving })
+            {
+                manager.setAlgorithm(algorithm);
+                manager.setAnimation(animation);
+                // the first frame after a switch may allocate, the steady frames measured after it must not
+                manager.paint();
+                const int allocations = manager.arenaAllocations();
+                QJsonObject result = measure("SceneManager::paint", options, [&manager]() { manager.paint(); });
+                result["allocations"] = manager.arenaAllocations() - allocations;
+                // the arena only counts its own buffers, the operator new calls of one more steady frame count the rest
+                const qint64 calls = heapAllocations.load();
+                manager.paint();
+                result["heapAllocations"] = double(heapAllocations.load() - calls);
+                result["algorithm"] = name;
+                result["animation"] = animation == Animation::Enum::Rotation ? "Rotation" : "Moving";
+                result["format"] = format == QImage::Format_ARGB32 ? "ARGB32" : "ARGB32_Premultiplied";
+                result["threads"] = threads;
+                results.append(result);
+            }
+        }
+    }
+    manager.setIsPlaying(false);
+}
+
+/*!
+ * \brief Returns the name of the instruction set the kernels dispatch to.
+ * \return The name of the detected instruction set.
+ */
+QString simdName()
+{
+    switch (simdLevel())
+    {
+        case SimdLevel::AVX2:
+        {
+            return "AVX2";
+        }
+        case SimdLevel::SSE2:
+        {
+            return "SSE2";
+        }
+        default:
+        {
+            return "Scalar";
+        }
+    }
+}
+}
+
+int main(int argc, char *argv[]) {
+    // the scene is only painted into images, no window is ever shown
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Bezier-Spinning-Benchmark");
+
+    QList<int> defaultThreads;
+    for (int threads = 1; threads < QThread::idealThreadCount(); threads *= 2)
+    {
+        defaultThreads.append(threads);
+    }
+    defaultThreads.append(QThread::idealThreadCount());
+    QStringList threadNames;
+    for (const int& threads : defaultThreads)
+    {
+        threadNames.append(QString::number(threads));
+    }
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times the rotation kernels, the curve evaluation and the painting of frames, and writes the results as JSON.");
+    parser.addHelpOption();
+    const QCommandLineOption outputOption({ "o", "output" }, "Write the results to <file> instead of the standard output.", "file");
+    const QCommandLineOption sizesOption("sizes", "Comma-separated sides of the sprites.", "list", "150,256,512,1024,2048,4096");
+    const QCommandLineOption pointsOption("points", "Comma-separated numbers of control points of the Bezier curve.", "list", "3,5,10,15,20,100,1000");
+    const QCommandLineOption splinePointsOption("spline-points", "Comma-separated numbers of control points of the spline.", "list", "3,20,1000,100000");
+    const QCommandLineOption threadsOption("threads", "Comma-separated numbers of threads.", "list", threadNames.join(','));
+    const QCommandLineOption timeOption("min-time", "Minimal time of every measurement in milliseconds.", "ms", "200");
+    const QCommandLineOption tileOption("tile-bytes", "Bytes of the tiles of rows the image kernels are split into.", "bytes",
+                                        QString::number(Executor::instance().tileBytes()));
+    const QCommandLineOption iterationsOption("min-iterations", "Minimal number of calls of every measurement.", "count", "5");
+    const QCommandLineOption seedOption("seed", "Seed of the control points of the curves.", "seed", "0");
+    parser.addOptions({ outputOption, sizesOption, pointsOption, splinePointsOption, threadsOption, tileOption, timeOption, iterationsOption, seedOption });
+    parser.process(app);
+    Executor::instance().setTileBytes(parser.value(tileOption).toLongLong());
+
+    const Options options { qMax(0, parser.value(timeOption).toInt()), qMax(1, parser.value(iterationsOption).toInt()),
+                            parser.value(seedOption).toUInt() };
+    const QList<int> sizes = parseList(parser.value(sizesOption));
+    const QList<int> points = parseList(parser.value(pointsOption));
+    const QList<int> splinePoints = parseList(parser.value(splinePointsOption));
+    const QList<int> threads = parseList(parser.value(threadsOption));
+
+    QJsonArray results;
+    for (const int& count : threads)
+    {
+        Executor::instance().setThreadCount(qMax(1, count));
+        for (const int& size : sizes)
+        {
+            benchmarkKernels(results, options, size, count);
+        }
+        for (const int& point : points)
+        {
+            BezierCurve curve(qMax(3, point), options.seed);
+            benchmarkCurve(results, options, curve, "BezierCurve", qMax(3, point), count);
+        }
+        for (const int& point : splinePoints)
+        {
+            SplineCurve curve(qMax(3, point), options.seed);
+            benchmarkCurve(results, options, curve, "SplineCurve", qMax(3, point), count);
+        }
+        benchmarkPaint(results, options, count);
+    }
+
+    QJsonObject report;
+    report["qt"] = qVersion();
+    report["simd"] = simdName();
+    report["idealThreadCount"] = QThread::idealThreadCount();
+    report["tileBytes"] = Executor::instance().tileBytes();
+    report["seed"] = qint64(options.seed);
+    report["results"] = results;
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    QFile output;
+    if (parser.isSet(outputOption))
+    {
+        output.setFileName(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            qCritical() << "Cannot write" << output.fileName();
+            return 1;
+        }
+    }
+    else if (!output.open(stdout, QIODevice::WriteOnly))
+    {
+        return 1;
+    }
+    output.write(json);
+    return 0;
+}
@@ -1,25 +1,39 @@
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QRandomGenerator>
+#include <QThread>
 
+#include "Executor.h"
 #include "SceneManager.h"
-#include "ImageProvider.h"
+#include "SceneItem.h"
 #include "Enums.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("Bakaczor");
+    QCoreApplication::setApplicationName("Bezier-Spinning");
 
-    QPointer<SceneManager> manager = new SceneManager(nullptr, &app);
-    QPointer<ImageProvider> sceneProvider = new ImageProvider(manager->scene);
-    QPointer<ImageProvider> imageProvider = new ImageProvider(manager->image);
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption threadsOption("threads", "Number of threads rotating the sprite and evaluating the curve.", "count",
+                                           QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption seedOption("seed", "Seed of the first curve, a random one by default.", "seed");
+    parser.addOptions({ threadsOption, seedOption });
+    parser.process(app);
+    Executor::instance().setThreadCount(qMax(1, parser.value(threadsOption).toInt()));
+    const quint32 seed = parser.isSet(seedOption) ? parser.value(seedOption).toUInt() : QRandomGenerator::global()->generate();
+
+    QPointer<SceneManager> manager = new SceneManager(seed, &app);
 
     QQmlApplicationEngine engine;
     engine.rootContext()->setContextProperty("SceneManager", manager);
-    engine.addImageProvider(QString("SceneProvider"), sceneProvider);
-    engine.addImageProvider(QString("ImageProvider"), imageProvider);
 
     qmlRegisterUncreatableType<Algorithm>("com.algorithm.enum", 1, 0, "Algo", "Cannot create Algorithm in QML");
     qmlRegisterUncreatableType<Animation>("com.animation.enum", 1, 0, "Anim", "Cannot create Animation in QML");
+    qmlRegisterUncreatableType<CurveType>("com.curvetype.enum", 1, 0, "CurveT", "Cannot create CurveType in QML");
+    qmlRegisterType<SceneItem>("com.scene.item", 1, 0, "SceneItem");
 
     const QUrl url(u"qrc:/Bezier-Spinning/main.qml"_qs);
     QObject::connect(&engine, &QQmlApplicationEngine::objectCreated, &app,
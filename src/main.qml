@@ -4,6 +4,8 @@ import QtQuick.Controls.Basic
 
 import com.algorithm.enum 1.0
 import com.animation.enum 1.0
+import com.curvetype.enum 1.0
+import com.scene.item 1.0
 
 ApplicationWindow {
     id: main_window
@@ -17,16 +19,6 @@ ApplicationWindow {
     readonly property int offset: 6
     readonly property int boxWidth: 180
 
-    Connections {
-        target: SceneManager
-        function onSceneChanged() {
-            scene.reload();
-        }
-        function onImageChanged() {
-            image.reload();
-        }
-    }
-
     Rectangle {
         anchors.fill: parent
         color: "lightgrey"
@@ -48,23 +40,89 @@ ApplicationWindow {
                     GroupBox {
                         focus: false
                         spacing: 5
-                        title: "Number of points (3 - 20)"
+                        title: "Number of points (3 - " + SceneManager.maxPoints + ")"
                         implicitWidth: boxWidth
 
-                        Row {
+                        Column {
                             focus: false
                             spacing: 5
-                            TextField {
-                                id: pointsTextField
-                                height: 30
-                                width: 75
-                            }
-                            Button {
-                                height: 30
-                                width: 75
-                                text: "Generate"
-                                onClicked: {
-                                    SceneManager.generate(pointsTextField.text);
+
+                            Row {
+                                focus: false
+                                spacing: 5
+                                TextField {
+                                    id: pointsTextField
+                                    height: 30
+                                    width: 75
+                                }
+                                Button {
+                                    height: 30
+                                    width: 75
+                                    text: "Generate"
+                                    onClicked: {
+                                        SceneManager.generate(pointsTextField.text);
+                                    }
+                                }
+                            }
+                            Row {
+                                focus: false
+                                spacing: 5
+                                TextField {
+                                    height: 30
+                                    width: 75
+                                    text: SceneManager.seed
+                                    validator: RegularExpressionValidator {
+                                        regularExpression: /[0-9]{1,10}/
+                                    }
+                                    onEditingFinished: {
+                                        SceneManager.seed = Math.min(Number(text), 4294967295);
+                                    }
+                                }
+                                Button {
+                                    height: 30
+                                    width: 75
+                                    text: "New seed"
+                                    onClicked: {
+                                        SceneManager.randomizeSeed();
+                                        SceneManager.generate(pointsTextField.text);
+                                    }
+                                }
+                            }
+                            Row {
+                                focus: false
+                                spacing: 5
+                                Label {
+                                    text: "Limit"
+                                    anchors.verticalCenter: parent.verticalCenter
+                                }
+                                SpinBox {
+                                    height: 30
+                                    width: 140
+                                    from: 3
+                                    to: 100000
+                                    editable: true
+                                    value: SceneManager.maxPoints
+                                    onValueModified: {
+                                        SceneManager.maxPoints = value;
+                                    }
+                                }
+                            }
+                            Row {
+                                focus: false
+                                spacing: 5
+                                RadioButton {
+                                    text: "Bezier"
+                                    checked: SceneManager.curveType === CurveT.Bezier
+                                    onClicked: {
+                                        SceneManager.curveType = CurveT.Bezier;
+                                    }
+                                }
+                                RadioButton {
+                                    text: "Spline"
+                                    checked: SceneManager.curveType === CurveT.Spline
+                                    onClicked: {
+                                        SceneManager.curveType = CurveT.Spline;
+                                    }
                                 }
                             }
                         }
@@ -78,6 +136,33 @@ ApplicationWindow {
                         }
                     }
 
+                    Row {
+                        focus: false
+                        spacing: 5
+                        Label {
+                            text: "Tolerance (px)"
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                        SpinBox {
+                            height: 30
+                            width: 90
+                            from: 5
+                            to: 1000
+                            stepSize: 5
+                            editable: true
+                            value: Math.round(SceneManager.curveTolerance * 100)
+                            textFromValue: function(value) {
+                                return (value / 100).toFixed(2);
+                            }
+                            valueFromText: function(text) {
+                                return Math.round(parseFloat(text) * 100);
+                            }
+                            onValueModified: {
+                                SceneManager.curveTolerance = value / 100;
+                            }
+                        }
+                    }
+
                     GroupBox {
                         focus: false
                         spacing: 5
@@ -87,18 +172,12 @@ ApplicationWindow {
                         Row {
                             focus: false
                             spacing: 7
-                            Image {
+                            SceneItem {
                                 id: image
                                 width: 100
                                 height: 100
-                                source: "image://ImageProvider/image"
-                                cache: false
-
-                                function reload() {
-                                    var oldSource = image.source;
-                                    image.source = "";
-                                    image.source = oldSource;
-                                }
+                                manager: SceneManager
+                                frame: SceneItem.Image
                             }
                             Column {
                                 focus: false
@@ -141,12 +220,31 @@ ApplicationWindow {
                                     SceneManager.algorithm = Algo.Naive;
                                 }
                             }
+                            RadioButton {
+                                text: "Bilinear"
+                                onClicked: {
+                                    SceneManager.algorithm = Algo.Bilinear;
+                                }
+                            }
+                            RadioButton {
+                                text: "Bicubic"
+                                onClicked: {
+                                    SceneManager.algorithm = Algo.Bicubic;
+                                }
+                            }
                             RadioButton {
                                 text: "Triple Shear"
                                 onClicked: {
                                     SceneManager.algorithm = Algo.Shear;
                                 }
                             }
+                            CheckBox {
+                                text: "Sprite atlas"
+                                checked: false
+                                onClicked: {
+                                    SceneManager.isAtlasEnabled = !SceneManager.isAtlasEnabled;
+                                }
+                            }
                         }
                     }
 
@@ -193,44 +291,91 @@ ApplicationWindow {
                                     }
                                 }
                             }
+                            Row {
+                                focus: false
+                                spacing: 5
+                                Label {
+                                    text: "FPS"
+                                    anchors.verticalCenter: parent.verticalCenter
+                                }
+                                SpinBox {
+                                    height: 30
+                                    width: 130
+                                    from: 1
+                                    to: 240
+                                    editable: true
+                                    value: SceneManager.targetFps
+                                    onValueModified: {
+                                        SceneManager.targetFps = value;
+                                    }
+                                }
+                            }
+                            Label {
+                                text: "Dropped frames: " + SceneManager.droppedFrames
+                            }
                         }
                     }
                 }
             }
 
-            Image {
+            SceneItem {
                 id: scene
                 width: parent.width - 200
                 height: parent.height
-                source: "image://SceneProvider/scene"
-                cache: false
+                manager: SceneManager
+                frame: SceneItem.Scene
                 focus: true
 
-                function reload() {
-                    var oldSource = scene.source;
-                    scene.source = "";
-                    scene.source = oldSource;
-                }
-
                 MouseArea {
                    id: mouseArea
                    anchors.fill: parent
                    hoverEnabled: true
 
+                    property int startX: 0
+                    property int startY: 0
+                    property bool isScrubbing: false
+
                     onPressed: {
-                       SceneManager.checkPoints(mouseArea.mouseX + offset, mouseArea.mouseY + offset);
-                       SceneManager.startDragging();
+                        if (SceneManager.checkPoints(mouseArea.mouseX + offset, mouseArea.mouseY + offset)) {
+                            SceneManager.startDragging();
+                        } else if (SceneManager.jumpTo(mouseArea.mouseX + offset, mouseArea.mouseY + offset, 10)) {
+                            // pressing on the curve moves the sprite there, and it follows the mouse until released
+                            isScrubbing = true;
+                        } else {
+                            // pressing beside the points spans a rectangle selecting all points inside it
+                            startX = mouseArea.mouseX;
+                            startY = mouseArea.mouseY;
+                            selectionBand.visible = true;
+                        }
                     }
                     onReleased: {
                         if (SceneManager.isDragging) {
                             SceneManager.stopDragging();
                         }
+                        isScrubbing = false;
+                        if (selectionBand.visible) {
+                            selectionBand.visible = false;
+                            SceneManager.selectPoints(startX + offset, startY + offset, mouseArea.mouseX + offset, mouseArea.mouseY + offset);
+                        }
                     }
                     onPositionChanged: {
                         if (SceneManager.isDragging) {
                             SceneManager.movePoint(mouseArea.mouseX + offset, mouseArea.mouseY + offset);
+                        } else if (isScrubbing) {
+                            SceneManager.jumpTo(mouseArea.mouseX + offset, mouseArea.mouseY + offset, -1);
                         }
                     }
+
+                    Rectangle {
+                        id: selectionBand
+                        visible: false
+                        x: Math.min(mouseArea.startX, mouseArea.mouseX)
+                        y: Math.min(mouseArea.startY, mouseArea.mouseY)
+                        width: Math.abs(mouseArea.mouseX - mouseArea.startX)
+                        height: Math.abs(mouseArea.mouseY - mouseArea.startY)
+                        color: "#200000ff"
+                        border.color: "blue"
+                    }
                 }
             }
         }